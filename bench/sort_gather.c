@@ -0,0 +1,83 @@
+/*
+Benchmark of UDSort() for linked lists of int values, used to choose UD_SORT_GATHER_MIN_SIZE in "uni_deque.c".
+
+UDSort() sorts lists of at least UD_SORT_GATHER_MIN_SIZE elements by their data pointers gathered in an array, and smaller lists by
+relinking the elements. Build the benchmark once for each way and compare the times per size. The sizes where the times of both builds
+meet show the crossover:
+
+  gcc -O2 -DUD_SORT_GATHER_MIN_SIZE=UINT64_MAX -o sort_inplace bench/sort_gather.c uni_deque.c -lpthread
+  gcc -O2 -DUD_SORT_GATHER_MIN_SIZE=1 -o sort_gathered bench/sort_gather.c uni_deque.c -lpthread
+
+Each size is sorted with the elements allocated in the order of the list ("ordered"), and with elements that were scattered across the
+memory by relinking them in an earlier sort ("scattered"). The time is averaged over sorts of about 4 million elements in total.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "../uni_deque.h"
+
+static int CmpInt(const void *p_1, const void *p_2)
+{
+  int a = *(const int *)p_1, b = *(const int *)p_2;
+  return (a > b) - (a < b);
+}
+
+static unsigned NextRandom(unsigned long long *p_state)
+{
+  *p_state = *p_state * 6364136223846793005ULL + 1442695040888963407ULL;
+  return (unsigned)(*p_state >> 33);
+}
+
+/* Assigns a new random value to the element, passed to UDForEach() along with the state of the random numbers. */
+static int RandomizeCallback(void *p_data, void *p_state)
+{
+  *(int *)p_data = (int)NextRandom((unsigned long long *)p_state);
+  return 1;
+}
+
+/* Returns the average number of milliseconds a sort of a list of the specified size takes. */
+static double TimeSorts(const ud_size_t size, const int scattered, unsigned long long *p_state)
+{
+  unsigned repeat = size < 4194304u ? (unsigned)(4194304u / size) : 1u;
+  double seconds = 0.0;
+  for (unsigned i = 0u; i < repeat; ++i)
+  {
+    ud_t deq = UDOpen();
+    if (deq == NULL)
+      exit(1);
+
+    for (ud_size_t j = 0u; j < size; ++j)
+      UDPushBackI(deq, (int)NextRandom(p_state));
+
+    if (scattered != 0)
+    {
+      // the elements are relinked in the order of their values, new values keep this order random with regard to the memory
+      UDSort(deq, CmpInt);
+      UDForEach(deq, 0u, (ud_ssize_t)size, RandomizeCallback, p_state);
+    }
+
+    clock_t start = clock();
+    if (UDSort(deq, CmpInt) == 0)
+      exit(1);
+
+    seconds += (double)(clock() - start) / CLOCKS_PER_SEC;
+    UDClose(deq);
+  }
+
+  return seconds * 1000.0 / repeat;
+}
+
+int main(void)
+{
+  unsigned long long state = 42u;
+  puts("         N    ordered ms  scattered ms");
+  for (ud_size_t size = 512u; size <= 2097152u; size *= 2u)
+  {
+    double ordered = TimeSorts(size, 0, &state);
+    double scattered = TimeSorts(size, 1, &state);
+    printf("%10" PRI_UD_SIZE(u) "  %12.3f  %12.3f\n", size, ordered, scattered);
+  }
+
+  return 0;
+}
@@ -0,0 +1,74 @@
+/*
+Benchmark of UDSortParallel() against UDSort() for deques of int values, used to check the speedup on machines with several processors.
+
+  gcc -O2 -o sort_parallel bench/sort_parallel.c uni_deque.c -lpthread
+  ./sort_parallel [number of elements]
+
+On Windows, compile without -lpthread (e.g. cl /O2 bench\sort_parallel.c uni_deque.c), the threads are started using _beginthreadex().
+
+The deque (4194304 elements by default) is filled with random values and sorted by UDSort() and by UDSortParallel() with 2, 4, 8, 16,
+32, and 64 threads, both for a linked list and for a block map. The speedup is the time of UDSort() divided by the time of
+UDSortParallel(). Wall clock time is measured, it requires C11 timespec_get(). At least UD_SORT_PARALLEL_MIN_SIZE (65536) elements per
+thread are used, fewer threads are started for smaller deques. The speedup is limited by the number of processors of the machine.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "../uni_deque.h"
+
+static int CmpInt(const void *p_1, const void *p_2)
+{
+  int a = *(const int *)p_1, b = *(const int *)p_2;
+  return (a > b) - (a < b);
+}
+
+static unsigned NextRandom(unsigned long long *p_state)
+{
+  *p_state = *p_state * 6364136223846793005ULL + 1442695040888963407ULL;
+  return (unsigned)(*p_state >> 33);
+}
+
+static double Now(void)
+{
+  struct timespec ts;
+  timespec_get(&ts, TIME_UTC);
+  return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/* Returns the number of milliseconds the sort of a deque of random values takes, UDSort() is called if thread_count is 0. */
+static double TimeSort(const int blocks, const ud_size_t size, const ud_size_t thread_count)
+{
+  unsigned long long state = 42u;
+  ud_t deq = blocks != 0 ? UDOpenBlocks() : UDOpen();
+  if (deq == NULL)
+    exit(1);
+
+  for (ud_size_t i = 0u; i < size; ++i)
+    UDPushBackI(deq, (int)NextRandom(&state));
+
+  double start = Now();
+  if ((thread_count == 0u ? UDSort(deq, CmpInt) : UDSortParallel(deq, CmpInt, thread_count)) == 0)
+    exit(1);
+
+  double ms = (Now() - start) * 1000.0;
+  UDClose(deq);
+  return ms;
+}
+
+int main(int argc, char *argv[])
+{
+  ud_size_t size = argc > 1 ? (ud_size_t)strtoull(argv[1], NULL, 10) : 4194304u;
+  for (int blocks = 0; blocks < 2; ++blocks)
+  {
+    double sequential = TimeSort(blocks, size, 0u);
+    printf("%s, %" PRI_UD_SIZE(u) " elements\n   threads         ms   speedup\n   UDSort  %9.1f\n", blocks != 0 ? "UDOpenBlocks" : "UDOpen", size, sequential);
+    for (ud_size_t thread_count = 2u; thread_count <= 64u; thread_count *= 2u)
+    {
+      double parallel = TimeSort(blocks, size, thread_count);
+      printf("%9" PRI_UD_SIZE(u) "  %9.1f  %8.2f\n", thread_count, parallel, sequential / parallel);
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,145 @@
+/*
+Test of UDSortParallel() and of the specialized UDSortParallelAsc... and UDSortParallelDesc... functions. The results are compared with
+the results of UDSort() and of the UDSortAsc... and UDSortDesc... functions, element by element. The records to be sorted have few
+distinct keys, and their sequence numbers show whether the order of records of equal keys is retained.
+
+Lower the minimum number of elements per thread so that the segments and the splits of the merges are exercised with small deques:
+
+  gcc -O2 -DUD_SORT_PARALLEL_MIN_SIZE=16 -o sort_parallel tests/sort_parallel.c uni_deque.c -lpthread
+  ./sort_parallel
+
+Compile with -fsanitize=thread in addition in order to check the threads for data races.
+The program prints the failed cases, and returns 0 if all cases passed.
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "../uni_deque.h"
+
+struct record
+{
+  int       key;
+  unsigned  seq;
+};
+
+static int CmpRecord(const void *p_1, const void *p_2)
+{
+  int a = ((const struct record *)p_1)->key, b = ((const struct record *)p_2)->key;
+  return (a > b) - (a < b);
+}
+
+static size_t HashRecord(const void *p_data)
+{
+  return (size_t)((const struct record *)p_data)->key;
+}
+
+static ud_t OpenRecords(const int engine)
+{
+  switch (engine)
+  {
+    case 0: return UDOpen();
+    case 1: return UDOpenBlocks();
+    case 2: return UDOpenIndexedList();
+    case 3: return UDOpenHashed(HashRecord, CmpRecord);
+    case 4: return UDOpenSized(sizeof(struct record));
+    case 5: return UDOpenCompact(sizeof(struct record));
+    case 6: return UDOpenPooled(0u);
+    default: return UDOpenArena(0u);
+  }
+}
+
+static const char *const engine_names[] = { "UDOpen", "UDOpenBlocks", "UDOpenIndexedList", "UDOpenHashed", "UDOpenSized", "UDOpenCompact", "UDOpenPooled", "UDOpenArena" };
+
+static unsigned NextRandom(unsigned long long *p_state)
+{
+  *p_state = *p_state * 6364136223846793005ULL + 1442695040888963407ULL;
+  return (unsigned)(*p_state >> 33);
+}
+
+/* Returns 1 if both deques have the same size and the same values. */
+static int SameValues(const ud_t deq_1, const ud_t deq_2, const size_t value_size)
+{
+  if (UDSize(deq_1) != UDSize(deq_2))
+    return 0;
+
+  for (ud_size_t i = 0u; i < UDSize(deq_1); ++i)
+  {
+    if (memcmp(UDAt(deq_1, i), UDAt(deq_2, i), value_size) != 0)
+      return 0;
+  }
+
+  return 1;
+}
+
+static int TestRecords(const int engine, const ud_size_t size, const ud_size_t thread_count, unsigned long long *p_state)
+{
+  ud_t expected = OpenRecords(engine), actual = OpenRecords(engine);
+  if (expected == NULL || actual == NULL)
+    return 0;
+
+  for (ud_size_t i = 0u; i < size; ++i)
+  {
+    struct record value = { (int)(NextRandom(p_state) % 8u), (unsigned)i };
+    UDPushBack(expected, &value, sizeof(value));
+    UDPushBack(actual, &value, sizeof(value));
+  }
+
+  int ret = UDSort(expected, CmpRecord) != 0 && UDSortParallel(actual, CmpRecord, thread_count) != 0 && SameValues(expected, actual, sizeof(struct record));
+  UDClose(expected);
+  UDClose(actual);
+  return ret;
+}
+
+static int TestInts(const ud_size_t size, const ud_size_t thread_count, const int descending, unsigned long long *p_state)
+{
+  ud_t expected = UDOpenBlocks(), actual = UDOpen();
+  if (expected == NULL || actual == NULL)
+    return 0;
+
+  for (ud_size_t i = 0u; i < size; ++i)
+  {
+    int value = (int)NextRandom(p_state) - (int)(NextRandom(p_state) / 2u);
+    UDPushBackI(expected, value);
+    UDPushBackI(actual, value);
+  }
+
+  int ret = descending != 0 ? UDSortDescI(expected) != 0 && UDSortParallelDescI(actual, thread_count) != 0
+                            : UDSortAscI(expected) != 0 && UDSortParallelAscI(actual, thread_count) != 0;
+  ret = ret != 0 && SameValues(expected, actual, sizeof(int));
+  UDClose(expected);
+  UDClose(actual);
+  return ret;
+}
+
+int main(void)
+{
+  static const ud_size_t sizes[] = { 1u, 15u, 16u, 17u, 31u, 100u, 1000u, 4099u };
+  unsigned long long state = 42u;
+  int failed = 0;
+  for (size_t s = 0u; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+  {
+    for (ud_size_t thread_count = 0u; thread_count < 70u; ++thread_count)
+    {
+      for (int engine = 0; engine < 8; ++engine)
+      {
+        if (TestRecords(engine, sizes[s], thread_count, &state) == 0)
+        {
+          printf("FAILED: records, %s, %" PRI_UD_SIZE(u) " elements, %" PRI_UD_SIZE(u) " threads\n", engine_names[engine], sizes[s], thread_count);
+          failed = 1;
+        }
+      }
+
+      for (int descending = 0; descending < 2; ++descending)
+      {
+        if (TestInts(sizes[s], thread_count, descending, &state) == 0)
+        {
+          printf("FAILED: %s, %" PRI_UD_SIZE(u) " elements, %" PRI_UD_SIZE(u) " threads\n", descending != 0 ? "UDSortParallelDescI" : "UDSortParallelAscI", sizes[s], thread_count);
+          failed = 1;
+        }
+      }
+    }
+  }
+
+  puts(failed != 0 ? "sort_parallel: FAILED" : "sort_parallel: passed");
+  return failed;
+}
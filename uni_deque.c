@@ -18,23 +18,349 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <stdlib.h>
 #include <string.h>
 #include <stdint.h>
+#include <wchar.h>
 #include "uni_deque.h"
 
+#if !defined(UD_NO_THREADS) && defined(_WIN32)
+# ifndef WIN32_LEAN_AND_MEAN
+#  define WIN32_LEAN_AND_MEAN
+# endif
+# include <windows.h>
+# include <process.h>
+# define UD_USE_WIN32_THREADS
+#elif !defined(UD_NO_THREADS)
+# include <pthread.h>
+# define UD_USE_PTHREADS
+#endif
+
+/* number of data pointers in a block of the block map (power of 2) */
+#define UD_BLOCK_SLOTS 512u
+
+/* index that marks the absence of a node in the node table, and indexes of the links in a node */
+#define UD_NIL_NODE UINT32_MAX
+#define UD_LINK_PREVIOUS 0
+#define UD_LINK_NEXT 1
+
+/* number of elements in a slab of the element pool */
+#define UD_POOL_SLAB_CELLS 64u
+
+/* default number of bytes in a chunk of an arena */
+#define UD_ARENA_CHUNK_SIZE 65536u
+
+/* default number of bytes in a page of a string arena */
+#define UD_STR_PAGE_SIZE 65536u
+
+/* maximum number of skip list levels above the list of an indexed list, an element is promoted to the next level with a probability of 1/4 */
+#define UD_SKIP_MAX_LEVELS 32
+
+/* initial and minimum number of buckets in the hash table of a hashed deque (power of 2) */
+#define UD_HASH_MIN_BUCKETS 16u
+
+/* bits per value and minimum number of values that the Bloom filter of a deque is sized for, and number of bits set for each value */
+#define UD_FILTER_BITS_PER_VALUE 16u
+#define UD_FILTER_MIN_VALUES 64u
+#define UD_FILTER_PROBES 4u
+
+/* maximum distance between the finger and an element of an indexed list that is rather reached by following the list than by the skip list */
+#define UD_FINGER_SKIP_DISTANCE 16u
+
+/* minimum number of elements that the specialized functions for integral values sort using a radix sort rather than UDSort() */
+#define UD_RADIX_MIN_SIZE 256u
+
+/* maximum number of leading characters that the radix sort of strings compares by prefixes, strings of longer common prefixes are merge
+   sorted; and maximum number of keyed items that are sorted by insertion rather than by the radix sort */
+#define UD_STR_SORT_MAX_DEPTH 256u
+#define UD_KEYED_INSERTION_SIZE 32u
+
+/* minimum number of elements of a list that UDSort() sorts by their data pointers gathered in an array rather than by relinking the elements,
+   can be defined when compiling in order to measure both ways (see "bench/sort_gather.c") */
+#ifndef UD_SORT_GATHER_MIN_SIZE
+# define UD_SORT_GATHER_MIN_SIZE 4096u
+#endif
+
+/* minimum number of elements per thread of UDSortParallel() (can be defined when compiling, "tests/sort_parallel.c" lowers it to split the
+   merges of small deques), and maximum number of threads */
+#ifndef UD_SORT_PARALLEL_MIN_SIZE
+# define UD_SORT_PARALLEL_MIN_SIZE 65536u
+#endif
+#define UD_SORT_MAX_THREADS 64u
+
+/* maximum number of pending runs of the natural merge sort, the lengths of the pending runs grow at least like the Fibonacci numbers */
+#define UD_SORT_MAX_RUNS 128
+
+/* number of elements in a row that a run supplies to a merge before the number of elements it supplies next is searched */
+#define UD_SORT_MIN_GALLOP 7u
+
 typedef  struct ud_element  * ud_element_t;
 
+/* type that has the strictest alignment requirement of the types processed by the specialized functions */
+union ud_align
+{
+    long double     ld;
+    long long       ll;
+    double          d;
+    void          * p;
+};
+
+/* The element and its value are allocated in one block of memory. The value is saved in the payload behind the links.
+   The size of the value occupies the padding in front of the payload, it lets searches for strings skip elements of a different length. */
 struct ud_element
 {
     ud_element_t    previous;
     ud_element_t    next;
     void          * data;
+    size_t          size;
+    union ud_align  payload[];
 };
 
-struct ud_detail
+/* storage engines */
+enum ud_storage
+{
+    UD_STORAGE_LIST = 0, // doubly-linked list of elements (default)
+    UD_STORAGE_BLOCKS,   // data pointers in fixed-size blocks indexed by a block map
+    UD_STORAGE_RING,     // values of a fixed size in a circular buffer
+    UD_STORAGE_COMPACT   // values of a fixed size in a table of nodes that are linked via 32-bit indexes
+};
+
+/* In a pooled deque each element is preceded by a header that refers to the slab it was taken from, or NULL if it was allocated separately. */
+union ud_cell_head
+{
+    struct ud_slab  * slab;
+    union ud_align    align;
+};
+
+/* Size of the cells in a slab, sufficient for values of up to the size of union ud_align. */
+#define UD_POOL_CELL_SIZE (sizeof(union ud_cell_head) + sizeof(struct ud_element) + sizeof(union ud_align))
+
+struct ud_slab
+{
+    struct ud_slab  * previous;
+    struct ud_slab  * next;
+    ud_size_t         live;    // number of cells in use
+    union ud_align    cells[]; // UD_POOL_SLAB_CELLS cells of UD_POOL_CELL_SIZE bytes
+};
+
+struct ud_pool
+{
+    int               enabled;
+    struct ud_slab  * slabs;      // list of slabs
+    ud_element_t      free_list;  // unused cells of all slabs, linked via their elements
+    ud_size_t         free_count; // number of cells in the free list
+    ud_size_t         max_free;   // number of unused cells to retain before slabs without cells in use are released
+};
+
+struct ud_chunk
+{
+    struct ud_chunk  * next;
+    size_t             used;
+    size_t             capacity;
+    union ud_align     bytes[];
+};
+
+struct ud_arena
+{
+    struct ud_chunk  * chunks;     // list of chunks, the first is the one that memory is currently taken from
+    size_t             chunk_size; // 0 if the deque doesn't use an arena
+};
+
+/* In a string arena each value is preceded by a header that refers to the page it was taken from and saves the size of the value. */
+union ud_str_head
+{
+    struct ud_str_value
+    {
+        struct ud_str_page  * page;
+        size_t                size;
+    } value;
+    union ud_align            align;
+};
+
+/* Any other value in a deque that uses the block map is preceded by a header that saves its size. */
+union ud_value_head
+{
+    size_t          size;
+    union ud_align  align;
+};
+
+struct ud_str_page
+{
+    struct ud_str_page  * previous;
+    struct ud_str_page  * next;
+    size_t                used;
+    size_t                capacity;
+    size_t                live;     // number of used bytes that belong to values not released yet
+    union ud_align        bytes[];
+};
+
+struct ud_strings
+{
+    struct ud_str_page  * pages;     // list of pages, the first is the one that memory is currently taken from
+    size_t                page_size; // 0 if the deque doesn't use a string arena
+};
+
+struct ud_block_map
+{
+    void        *** blocks; // array of pointers to blocks of UD_BLOCK_SLOTS data pointers, unused entries may be NULL
+    ud_size_t       count;  // number of entries in the blocks array
+    ud_size_t       first;  // slot position of the first element, counted from the begin of blocks[0]
+};
+
+struct ud_ring
+{
+    unsigned char  * buffer;
+    ud_size_t        capacity;  // number of values that fit into the buffer
+    ud_size_t        first;     // position of the first value in the buffer
+    int              bounded;   // the capacity is fixed, values that don't fit are handled according to the policy
+    ud_overflow_t    policy;
+};
+
+struct ud_compact
+{
+    unsigned char  * table;        // nodes, each consisting of the value followed by the indexes of the previous and the next node
+    uint32_t         capacity;     // number of nodes in the table
+    uint32_t         used;         // number of nodes at the begin of the table that have been in use, the rest is uninitialized
+    uint32_t         head;
+    uint32_t         tail;
+    uint32_t         free_list;    // nodes that are not in use anymore, linked via their next index
+    size_t           node_size;
+    size_t           links_offset; // offset of the indexes in a node
+};
+
+/* Link of an element on a level of the skip list. */
+struct ud_skip_link
+{
+    ud_element_t  previous;
+    ud_element_t  next;
+    ud_size_t     width;    // distance to the next element on this level, undefined for the last element
+};
+
+/* In an indexed list each element is preceded by the number of levels it is linked on, and the links are in front of this header, the
+   link for level 1 is the closest. */
+union ud_skip_head
+{
+    size_t          levels;
+    union ud_align  align;
+};
+
+/* Skip list of an indexed list. The positions of the first elements and the gaps behind the last elements on each level are saved relative
+   to an offset that is shifted if an element is added or removed at the begin or the end, so that the levels above a new or removed element
+   don't need to be updated. */
+struct ud_skip_index
+{
+    ud_size_t     levels;                          // number of levels in use
+    ud_element_t  first[UD_SKIP_MAX_LEVELS];
+    ud_element_t  last[UD_SKIP_MAX_LEVELS];
+    ud_size_t     first_pos[UD_SKIP_MAX_LEVELS];   // position of the first element minus front_shift
+    ud_size_t     last_gap[UD_SKIP_MAX_LEVELS];    // number of elements behind the last element minus back_shift
+    ud_size_t     front_shift;
+    ud_size_t     back_shift;
+    uint32_t      random;                          // state of the generator for the levels of new elements
+};
+
+/* In a hashed deque the links of the levels of each element are preceded by the link to the next element in the same bucket of the hash
+   table and the hash of the value. */
+union ud_hash_head
+{
+    struct ud_hash_entry
+    {
+        ud_element_t  chain;
+        size_t        hash;
+    } entry;
+    union ud_align    align;
+};
+
+/* Hash table of a hashed deque. Each bucket is a list of the elements whose hashes select the bucket. */
+struct ud_hash_index
+{
+    ud_element_t  * buckets;
+    ud_size_t       count;     // number of buckets (power of 2)
+    ud_hash_t       hash_func;
+    ud_cmp_t        cmp_func;  // NULL if the comparison function passed to UDFind() or UDRemove() is used
+};
+
+/* Bloom filter of the values in a deque. The bits of removed values can't be cleared. The filter is rebuilt before it is consulted if more
+   than half of the values added to it have been removed, or if more values have been added than it was sized for. */
+struct ud_filter
+{
+    uint64_t   * words;
+    ud_size_t    word_count; // number of 64-bit words (power of 2), 0 if the words could not be allocated
+    ud_size_t    capacity;   // number of values that the filter is sized for
+    ud_size_t    added;      // number of values added since the filter was built
+    ud_hash_t    hash_func;
+    ud_cmp_t     cmp_func;   // NULL if the filter is consulted for any comparison function
+};
+
+/* Sorted sequence of elements linked via their next pointers, pending to be merged by the natural merge sort of a list. */
+struct ud_run
 {
     ud_element_t  head;
     ud_element_t  tail;
-    ud_size_t     size;
-    int           err;
+};
+
+/* Data pointer along with the key of the value, sorted by the radix sort of integral values. */
+struct ud_keyed
+{
+    uint64_t   key;
+    void     * data;
+};
+
+/* Part of the work of UDSortParallel() that is done by one thread. A sort task sorts the items of the first range, using the same range of the
+   destination as buffer. A merge task merges the items of both ranges into the destination. */
+struct ud_sort_task
+{
+    void       ** src;
+    void       ** dest;
+    ud_size_t     first_begin;
+    ud_size_t     first_end;
+    ud_size_t     second_begin;
+    ud_size_t     second_end;
+    ud_size_t     dest_begin;
+    ud_cmp_t      cmp_func;
+    void       (* sort_items)(void **, const ud_size_t, void **, ud_cmp_t);
+    void       (* merge_items)(void **, const ud_size_t, void **, const ud_size_t, void **, ud_cmp_t);
+    void       (* run)(struct ud_sort_task *); // SortTask() or MergeTask(), called by the thread that does the task
+};
+
+/* Element of a list or node of a compact deque that was accessed last by its index. Traversals to other indexes start from there if it is
+   closer than the head and the tail. Its index is adjusted if elements are added or removed in front of it. */
+struct ud_finger
+{
+    int           valid;
+    ud_element_t  element;
+    uint32_t      node;
+    ud_size_t     index;
+};
+
+/* memory usage statistics of a deque, updated whenever memory is allocated, released, or assigned to an element */
+struct ud_usage
+{
+    ud_size_t  payload;
+    ud_size_t  metadata;
+    ud_size_t  free_bytes;
+    ud_size_t  peak;
+};
+
+struct ud_detail
+{
+    ud_element_t         head;
+    ud_element_t         tail;
+    ud_size_t            size;
+    int                  err;
+    enum ud_storage      storage;
+    struct ud_block_map  map;
+    struct ud_ring       ring;
+    struct ud_compact    compact;
+    size_t               elem_size; // size of the values in a deque that uses the ring buffer or the node table
+    void               * spare;     // buffer for the value of the element that was removed last from such a deque
+    struct ud_pool       pool;
+    struct ud_arena      arena;
+    struct ud_strings    strings;
+    struct ud_skip_index * skip; // NULL if the list is not indexed
+    struct ud_hash_index * hash; // NULL if the deque is not hashed
+    struct ud_filter     * filter; // NULL if no filter is attached to the deque
+    ud_cmp_t             sorted_cmp; // comparison function that the values are known to be sorted by, or NULL
+    struct ud_finger     finger;
+    struct ud_usage      usage;
+    ud_allocator_t       allocator;
 };
 
 
@@ -199,373 +525,3254 @@ int CmpDescWStr(const wchar_t *p_1, const wchar_t *p_2)
 }
 
 
-ud_t UDOpen()
+/* Mixes the bits of an integral value (finalizer of MurmurHash3). */
+static size_t HashInteger(uint64_t value)
 {
-  return (ud_t)calloc(1u, sizeof(struct ud_detail));
+  value ^= value >> 33;
+  value *= UINT64_C(0xff51afd7ed558ccd);
+  value ^= value >> 33;
+  value *= UINT64_C(0xc4ceb9fe1a85ec53);
+  value ^= value >> 33;
+  return (size_t)value;
 }
 
-void *UDPushFront(const ud_t deq, const void *const p_data, const size_t data_size)
+/* FNV-1a hash of a sequence of bytes. */
+static size_t HashBytes(const void *p_data, const size_t size)
 {
-  ud_element_t new_element = NULL;
-  void *new_data = NULL;
-  if ((new_element = (ud_element_t)malloc(sizeof(struct ud_element))) == NULL || (new_data = malloc(data_size)) == NULL)
+  uint64_t value = UINT64_C(0xcbf29ce484222325);
+  for (const unsigned char *p = (const unsigned char *)p_data, *end = p + size; p < end; ++p)
+    value = (value ^ *p) * UINT64_C(0x100000001b3);
+
+  return (size_t)(value ^ (value >> 32));
+}
+
+/* Floating point values are hashed as double, 0.0 and -0.0 compare equal and get the same hash. */
+static size_t HashDouble(double value)
+{
+  if (value == 0.0)
+    value = 0.0;
+
+  return HashBytes(&value, sizeof(double));
+}
+
+size_t UDHashC(const void *p_data)
+{
+  return HashInteger((uint64_t)*(const char *)p_data);
+}
+
+size_t UDHashSC(const void *p_data)
+{
+  return HashInteger((uint64_t)*(const signed char *)p_data);
+}
+
+size_t UDHashUC(const void *p_data)
+{
+  return HashInteger((uint64_t)*(const unsigned char *)p_data);
+}
+
+size_t UDHashS(const void *p_data)
+{
+  return HashInteger((uint64_t)*(const short *)p_data);
+}
+
+size_t UDHashUS(const void *p_data)
+{
+  return HashInteger((uint64_t)*(const unsigned short *)p_data);
+}
+
+size_t UDHashI(const void *p_data)
+{
+  return HashInteger((uint64_t)*(const int *)p_data);
+}
+
+size_t UDHashUI(const void *p_data)
+{
+  return HashInteger((uint64_t)*(const unsigned int *)p_data);
+}
+
+size_t UDHashL(const void *p_data)
+{
+  return HashInteger((uint64_t)*(const long *)p_data);
+}
+
+size_t UDHashUL(const void *p_data)
+{
+  return HashInteger((uint64_t)*(const unsigned long *)p_data);
+}
+
+size_t UDHashLL(const void *p_data)
+{
+  return HashInteger((uint64_t)*(const long long *)p_data);
+}
+
+size_t UDHashULL(const void *p_data)
+{
+  return HashInteger((uint64_t)*(const unsigned long long *)p_data);
+}
+
+size_t UDHashF(const void *p_data)
+{
+  return HashDouble((double)*(const float *)p_data);
+}
+
+size_t UDHashD(const void *p_data)
+{
+  return HashDouble(*(const double *)p_data);
+}
+
+size_t UDHashLD(const void *p_data)
+{
+  return HashDouble((double)*(const long double *)p_data);
+}
+
+size_t UDHashStr(const void *p_data)
+{
+  return HashBytes(p_data, strlen((const char *)p_data));
+}
+
+size_t UDHashWStr(const void *p_data)
+{
+  return HashBytes(p_data, wcslen((const wchar_t *)p_data) * sizeof(wchar_t));
+}
+
+
+static void *DefaultAlloc(void *context, size_t size)
+{
+  (void)context;
+  return malloc(size);
+}
+
+static void *DefaultRealloc(void *context, void *ptr, size_t size)
+{
+  (void)context;
+  return realloc(ptr, size);
+}
+
+static void DefaultFree(void *context, void *ptr)
+{
+  (void)context;
+  free(ptr);
+}
+
+static const ud_allocator_t default_allocator = { DefaultAlloc, DefaultRealloc, DefaultFree, NULL };
+
+/* Allocate, reallocate and release memory using the allocator of the deque. */
+static void *Alloc(const ud_t deq, const size_t size)
+{
+  return deq->allocator.alloc_func(deq->allocator.context, size);
+}
+
+static void *Realloc(const ud_t deq, void *ptr, const size_t size)
+{
+  return deq->allocator.realloc_func(deq->allocator.context, ptr, size);
+}
+
+static void Free(const ud_t deq, void *ptr)
+{
+  if (ptr != NULL)
+    deq->allocator.free_func(deq->allocator.context, ptr);
+}
+
+/* Adds the differences to the memory usage statistics and updates the peak usage. */
+static void Account(const ud_t deq, const ud_ssize_t payload, const ud_ssize_t metadata, const ud_ssize_t free_bytes)
+{
+  struct ud_usage *usage = &deq->usage;
+  usage->payload += (ud_size_t)payload;
+  usage->metadata += (ud_size_t)metadata;
+  usage->free_bytes += (ud_size_t)free_bytes;
+  if (usage->payload + usage->metadata + usage->free_bytes > usage->peak)
+    usage->peak = usage->payload + usage->metadata + usage->free_bytes;
+}
+
+/* Returns the size rounded up to a multiple of the size of union ud_align. */
+static size_t AlignedSize(const size_t size)
+{
+  return (size + sizeof(union ud_align) - 1u) / sizeof(union ud_align) * sizeof(union ud_align);
+}
+
+/* Returns the header in front of an element of an indexed list. */
+static union ud_skip_head *SkipHead(const ud_element_t element)
+{
+  return (union ud_skip_head *)element - 1;
+}
+
+/* Returns the link of an element of an indexed list on the specified level (1 for the lowest level above the list). */
+static struct ud_skip_link *SkipLink(const ud_element_t element, const ud_size_t level)
+{
+  return (struct ud_skip_link *)SkipHead(element) - level;
+}
+
+/* Returns the number of bytes in front of an element of an indexed list that is linked on the specified number of levels. */
+static size_t SkipTowerSize(const ud_size_t levels)
+{
+  return AlignedSize(levels * sizeof(struct ud_skip_link)) + sizeof(union ud_skip_head);
+}
+
+/* Returns the number of levels for a new element, at most one level more than the levels in use. */
+static ud_size_t SkipRandomLevels(struct ud_skip_index *skip)
+{
+  ud_size_t levels = 0u;
+  while (levels <= skip->levels && levels < UD_SKIP_MAX_LEVELS)
   {
-    deq->err = 1;
-    free(new_element);
-    return NULL;
+    // xorshift generator, two bits per level for the probability of 1/4
+    skip->random ^= skip->random << 13;
+    skip->random ^= skip->random >> 17;
+    skip->random ^= skip->random << 5;
+    if ((skip->random & 3u) != 0u)
+      break;
+
+    ++levels;
   }
 
-  new_element->data = memcpy(new_data, p_data, data_size);
-  deq->head != NULL ? (deq->head->previous = new_element) : (deq->tail = new_element);
-  new_element->next = deq->head;
-  new_element->previous = NULL;
-  deq->head = new_element;
-  ++deq->size;
-  deq->err = 0;
-  return new_data;
+  return levels;
 }
 
-void *UDFront(const ud_t deq)
+/* Returns the header of an element in a pooled deque. */
+static union ud_cell_head *CellHead(const ud_element_t element)
+{
+  return (union ud_cell_head *)element - 1;
+}
+
+/* Allocates a new slab and adds its cells to the free list of the pool. */
+static int PoolAddSlab(const ud_t deq)
+{
+  struct ud_pool *pool = &deq->pool;
+  struct ud_slab *slab = (struct ud_slab *)Alloc(deq, sizeof(struct ud_slab) + UD_POOL_SLAB_CELLS * UD_POOL_CELL_SIZE);
+  if (slab == NULL)
+    return 0;
+
+  Account(deq, 0, (ud_ssize_t)sizeof(struct ud_slab), (ud_ssize_t)(UD_POOL_SLAB_CELLS * UD_POOL_CELL_SIZE));
+  slab->live = 0u;
+  slab->previous = NULL;
+  slab->next = pool->slabs;
+  if (pool->slabs != NULL)
+    pool->slabs->previous = slab;
+
+  pool->slabs = slab;
+  for (ud_size_t i = 0u; i < UD_POOL_SLAB_CELLS; ++i)
+  {
+    union ud_cell_head *head = (union ud_cell_head *)((char *)slab->cells + i * UD_POOL_CELL_SIZE);
+    ud_element_t element = (ud_element_t)(head + 1);
+    head->slab = slab;
+    element->previous = NULL;
+    element->next = pool->free_list;
+    if (pool->free_list != NULL)
+      pool->free_list->previous = element;
+
+    pool->free_list = element;
+  }
+
+  pool->free_count += UD_POOL_SLAB_CELLS;
+  return 1;
+}
+
+/* Removes the cells of a slab that has no cells in use from the free list and releases the slab. */
+static void PoolFreeSlab(const ud_t deq, struct ud_slab *slab)
 {
-  if (deq->head == NULL)
+  struct ud_pool *pool = &deq->pool;
+  for (ud_size_t i = 0u; i < UD_POOL_SLAB_CELLS; ++i)
   {
-    deq->err = 1;
-    return NULL;
+    ud_element_t element = (ud_element_t)((union ud_cell_head *)((char *)slab->cells + i * UD_POOL_CELL_SIZE) + 1);
+    element->previous != NULL ? (element->previous->next = element->next) : (pool->free_list = element->next);
+    if (element->next != NULL)
+      element->next->previous = element->previous;
   }
 
-  deq->err = 0;
-  return deq->head->data;
+  pool->free_count -= UD_POOL_SLAB_CELLS;
+  Account(deq, 0, -(ud_ssize_t)sizeof(struct ud_slab), -(ud_ssize_t)(UD_POOL_SLAB_CELLS * UD_POOL_CELL_SIZE));
+  slab->previous != NULL ? (slab->previous->next = slab->next) : (pool->slabs = slab->next);
+  if (slab->next != NULL)
+    slab->next->previous = slab->previous;
+
+  Free(deq, slab);
+}
+
+/* Takes memory from the current chunk of the arena. Memory taken from the arena is not released before the whole arena is released. */
+static void *ArenaAlloc(const ud_t deq, size_t size)
+{
+  struct ud_arena *arena = &deq->arena;
+  struct ud_chunk *chunk = arena->chunks;
+  size = AlignedSize(size);
+  if (chunk == NULL || chunk->capacity - chunk->used < size)
+  {
+    size_t capacity = size > arena->chunk_size ? size : arena->chunk_size;
+    if ((chunk = (struct ud_chunk *)Alloc(deq, sizeof(struct ud_chunk) + capacity)) == NULL)
+      return NULL;
+
+    Account(deq, 0, (ud_ssize_t)sizeof(struct ud_chunk), (ud_ssize_t)capacity);
+    chunk->used = 0u;
+    chunk->capacity = capacity;
+    if (capacity > arena->chunk_size && arena->chunks != NULL)
+    {
+      // an oversized chunk is filled at once, keep taking memory from the current chunk
+      chunk->next = arena->chunks->next;
+      arena->chunks->next = chunk;
+    }
+    else
+    {
+      chunk->next = arena->chunks;
+      arena->chunks = chunk;
+    }
+  }
+
+  void *ptr = (char *)chunk->bytes + chunk->used;
+  chunk->used += size;
+  return ptr;
+}
+
+/* Releases all chunks of the arena. */
+static void ArenaRelease(const ud_t deq)
+{
+  // all free bytes and payload of the deque are in the chunks
+  ud_size_t chunk_bytes = 0u;
+  while (deq->arena.chunks != NULL)
+  {
+    struct ud_chunk *next = deq->arena.chunks->next;
+    chunk_bytes += sizeof(struct ud_chunk) + deq->arena.chunks->capacity;
+    Free(deq, deq->arena.chunks);
+    deq->arena.chunks = next;
+  }
+
+  Account(deq, -(ud_ssize_t)deq->usage.payload, -(ud_ssize_t)(chunk_bytes - deq->usage.payload - deq->usage.free_bytes), -(ud_ssize_t)deq->usage.free_bytes);
+}
+
+/* Takes memory for a value from the current page of the string arena. */
+static void *StrAlloc(const ud_t deq, const size_t data_size)
+{
+  struct ud_strings *strings = &deq->strings;
+  struct ud_str_page *page = strings->pages;
+  size_t size = sizeof(union ud_str_head) + AlignedSize(data_size);
+  if (page == NULL || page->capacity - page->used < size)
+  {
+    size_t capacity = size > strings->page_size ? size : strings->page_size;
+    if ((page = (struct ud_str_page *)Alloc(deq, sizeof(struct ud_str_page) + capacity)) == NULL)
+      return NULL;
+
+    Account(deq, 0, (ud_ssize_t)sizeof(struct ud_str_page), (ud_ssize_t)capacity);
+    page->used = page->live = 0u;
+    page->capacity = capacity;
+    if (capacity > strings->page_size && strings->pages != NULL)
+    {
+      // an oversized page is filled at once, keep taking memory from the current page
+      page->previous = strings->pages;
+      page->next = strings->pages->next;
+      strings->pages->next = page;
+    }
+    else
+    {
+      page->previous = NULL;
+      page->next = strings->pages;
+      strings->pages = page;
+    }
+
+    if (page->next != NULL)
+      page->next->previous = page;
+  }
+
+  union ud_str_head *head = (union ud_str_head *)((char *)page->bytes + page->used);
+  head->value.page = page;
+  head->value.size = data_size;
+  page->used += size;
+  page->live += size;
+  Account(deq, (ud_ssize_t)data_size, (ud_ssize_t)(size - data_size), -(ud_ssize_t)size);
+  return head + 1;
+}
+
+/* Returns the memory of a value to its page of the string arena. A page is released as soon as none of its values is in use anymore. */
+static void StrRelease(const ud_t deq, void *p_data)
+{
+  struct ud_strings *strings = &deq->strings;
+  union ud_str_head *head = (union ud_str_head *)p_data - 1;
+  struct ud_str_page *page = head->value.page;
+  size_t size = sizeof(union ud_str_head) + AlignedSize(head->value.size);
+  Account(deq, -(ud_ssize_t)head->value.size, -(ud_ssize_t)(size - head->value.size), (ud_ssize_t)size);
+  if ((page->live -= size) != 0u)
+    return;
+
+  if (page == strings->pages)
+  {
+    page->used = 0u; // the current page is reused from the begin
+    return;
+  }
+
+  page->previous->next = page->next;
+  if (page->next != NULL)
+    page->next->previous = page->previous;
+
+  Account(deq, 0, -(ud_ssize_t)sizeof(struct ud_str_page), -(ud_ssize_t)page->capacity);
+  Free(deq, page);
+}
+
+/* Sets (if set is nonzero) or tests the bits of the hash in the Bloom filter. Returns zero if any of the bits was not set before. */
+static int FilterBits(const struct ud_filter *filter, const size_t hash_value, const int set)
+{
+  uint64_t position = HashInteger((uint64_t)hash_value);
+  uint64_t step = (position >> 32) | 1u;
+  uint64_t mask = (uint64_t)filter->word_count * 64u - 1u;
+  int found = 1;
+  for (unsigned probe = 0u; probe < UD_FILTER_PROBES; ++probe, position += step)
+  {
+    uint64_t *word = filter->words + ((position & mask) >> 6);
+    uint64_t bit = UINT64_C(1) << (position & 63u);
+    found &= (*word & bit) != 0u;
+    if (set != 0)
+      *word |= bit;
+  }
+
+  return found;
+}
+
+/* Adds a value that has been added to the deque to the Bloom filter. */
+static void FilterAdd(const ud_t deq, const void *const p_data)
+{
+  struct ud_filter *filter = deq->filter;
+  if (filter->word_count != 0u)
+    FilterBits(filter, filter->hash_func(p_data), 1);
+
+  ++filter->added;
+}
+
+/* Returns the number of bytes that an element takes for a value of the specified size, and whether they are taken from memory counted as free. */
+static size_t ElementBytes(const ud_t deq, const size_t data_size, int *p_from_free)
+{
+  *p_from_free = deq->arena.chunk_size != 0u || (deq->pool.enabled != 0 && data_size <= sizeof(union ud_align));
+  if (deq->arena.chunk_size != 0u)
+    return AlignedSize(sizeof(struct ud_element) + data_size);
+
+  if (deq->pool.enabled == 0)
+    return sizeof(struct ud_element) + data_size;
+
+  return data_size <= sizeof(union ud_align) ? UD_POOL_CELL_SIZE : sizeof(union ud_cell_head) + sizeof(struct ud_element) + data_size;
+}
+
+/* Allocates a new element along with a copy of the data in its payload. */
+static ud_element_t NewElement(const ud_t deq, const void *const p_data, const size_t data_size)
+{
+  ud_element_t new_element = NULL;
+  struct ud_pool *pool = &deq->pool;
+  if (deq->skip != NULL)
+  {
+    // the links of the levels (and of the hash table) are allocated along with the element
+    ud_size_t levels = SkipRandomLevels(deq->skip);
+    size_t tower_size = SkipTowerSize(levels) + (deq->hash != NULL ? sizeof(union ud_hash_head) : 0u);
+    char *tower = (char *)Alloc(deq, tower_size + sizeof(struct ud_element) + data_size);
+    if (tower != NULL)
+    {
+      new_element = (ud_element_t)(tower + tower_size);
+      SkipHead(new_element)->levels = levels;
+      Account(deq, 0, (ud_ssize_t)tower_size, 0);
+    }
+  }
+  else if (deq->arena.chunk_size != 0u)
+    new_element = (ud_element_t)ArenaAlloc(deq, sizeof(struct ud_element) + data_size);
+  else if (pool->enabled == 0)
+    new_element = (ud_element_t)Alloc(deq, sizeof(struct ud_element) + data_size);
+  else if (data_size <= sizeof(union ud_align))
+  {
+    if (pool->free_list != NULL || PoolAddSlab(deq) != 0)
+    {
+      new_element = pool->free_list;
+      pool->free_list = new_element->next;
+      if (pool->free_list != NULL)
+        pool->free_list->previous = NULL;
+
+      --pool->free_count;
+      ++CellHead(new_element)->slab->live;
+    }
+  }
+  else
+  {
+    union ud_cell_head *head = (union ud_cell_head *)Alloc(deq, sizeof(union ud_cell_head) + sizeof(struct ud_element) + data_size);
+    if (head != NULL)
+    {
+      head->slab = NULL;
+      new_element = (ud_element_t)(head + 1);
+    }
+  }
+
+  if (new_element == NULL)
+  {
+    deq->err = 1;
+    return NULL;
+  }
+
+  int from_free = 0;
+  size_t bytes = ElementBytes(deq, data_size, &from_free);
+  Account(deq, (ud_ssize_t)data_size, (ud_ssize_t)(bytes - data_size), from_free != 0 ? -(ud_ssize_t)bytes : 0);
+  new_element->size = data_size;
+  new_element->data = memcpy(new_element->payload, p_data, data_size);
+  if (deq->filter != NULL)
+    FilterAdd(deq, new_element->data);
+
+  return new_element;
+}
+
+/* Releases an element that is not linked in the deque anymore. */
+static void ReleaseElement(const ud_t deq, const ud_element_t element)
+{
+  struct ud_pool *pool = &deq->pool;
+  int from_free = 0;
+  size_t bytes = ElementBytes(deq, element->size, &from_free);
+  Account(deq, -(ud_ssize_t)element->size, -(ud_ssize_t)(bytes - element->size), from_free != 0 ? (ud_ssize_t)bytes : 0);
+  if (deq->skip != NULL)
+  {
+    size_t tower_size = SkipTowerSize(SkipHead(element)->levels) + (deq->hash != NULL ? sizeof(union ud_hash_head) : 0u);
+    Account(deq, 0, -(ud_ssize_t)tower_size, 0);
+    Free(deq, (char *)element - tower_size);
+    return;
+  }
+
+  if (deq->arena.chunk_size != 0u)
+    return; // released along with the arena
+
+  if (pool->enabled == 0)
+  {
+    Free(deq, element);
+    return;
+  }
+
+  struct ud_slab *slab = CellHead(element)->slab;
+  if (slab == NULL)
+  {
+    Free(deq, CellHead(element));
+    return;
+  }
+
+  element->previous = NULL;
+  element->next = pool->free_list;
+  if (pool->free_list != NULL)
+    pool->free_list->previous = element;
+
+  pool->free_list = element;
+  ++pool->free_count;
+  if (--slab->live == 0u && pool->free_count > pool->max_free)
+    PoolFreeSlab(deq, slab);
+}
+
+/* Searches the list for the first element whose value begins with the same bytes as the data. Elements whose values are smaller than the
+   data are skipped without comparing the bytes. */
+static ud_element_t FindEqualElement(const ud_t deq, const void *const p_data, const size_t data_size, ud_size_t *p_index)
+{
+  ud_size_t index = 0u;
+  for (ud_element_t current_element = deq->head; current_element != NULL; current_element = current_element->next, ++index)
+  {
+    if (current_element->size >= data_size && memcmp(current_element->payload, p_data, data_size) == 0)
+    {
+      *p_index = index;
+      return current_element;
+    }
+  }
+
+  return NULL;
+}
+
+/* Returns the element that the data pointer belongs to. */
+static ud_element_t DataElement(void *p_data)
+{
+  return (ud_element_t)((char *)p_data - offsetof(struct ud_element, payload));
+}
+
+/* Position of the first element and gap behind the last element on a level. */
+static ud_size_t SkipFirstPos(const struct ud_skip_index *skip, const ud_size_t level)
+{
+  return skip->first_pos[level - 1u] + skip->front_shift;
+}
+
+static void SkipSetFirstPos(struct ud_skip_index *skip, const ud_size_t level, const ud_size_t pos)
+{
+  skip->first_pos[level - 1u] = pos - skip->front_shift;
+}
+
+static ud_size_t SkipLastGap(const struct ud_skip_index *skip, const ud_size_t level)
+{
+  return skip->last_gap[level - 1u] + skip->back_shift;
+}
+
+static void SkipSetLastGap(struct ud_skip_index *skip, const ud_size_t level, const ud_size_t gap)
+{
+  skip->last_gap[level - 1u] = gap - skip->back_shift;
+}
+
+/* Finds the last element in front of the specified position on each level in use. NULL and position -1 represent the begin of the list. */
+static void SkipSearch(const ud_t deq, const ud_size_t index, ud_element_t *predecessors, ud_ssize_t *positions)
+{
+  struct ud_skip_index *skip = deq->skip;
+  ud_element_t current_element = NULL;
+  ud_ssize_t pos = -1;
+  for (ud_size_t level = skip->levels; level > 0u; --level)
+  {
+    for (;;)
+    {
+      ud_element_t next = current_element == NULL ? skip->first[level - 1u] : SkipLink(current_element, level)->next;
+      if (next == NULL)
+        break;
+
+      ud_ssize_t next_pos = current_element == NULL ? (ud_ssize_t)SkipFirstPos(skip, level) : pos + (ud_ssize_t)SkipLink(current_element, level)->width;
+      if (next_pos >= (ud_ssize_t)index)
+        break;
+
+      current_element = next;
+      pos = next_pos;
+    }
+
+    predecessors[level - 1u] = current_element;
+    positions[level - 1u] = pos;
+  }
+}
+
+/* Returns the element at the specified position of an indexed list. */
+static ud_element_t SkipLocate(const ud_t deq, const ud_size_t index)
+{
+  ud_element_t predecessors[UD_SKIP_MAX_LEVELS];
+  ud_ssize_t positions[UD_SKIP_MAX_LEVELS];
+  ud_element_t current_element = deq->head;
+  ud_ssize_t pos = 0;
+  if (deq->skip->levels != 0u)
+  {
+    // search for the position behind the element so that the element itself can be found on the levels
+    SkipSearch(deq, index + 1u, predecessors, positions);
+    if (predecessors[0] != NULL)
+    {
+      current_element = predecessors[0];
+      pos = positions[0];
+    }
+  }
+
+  for ( ; pos < (ud_ssize_t)index; ++pos)
+    current_element = current_element->next;
+
+  return current_element;
+}
+
+/* Links a new element that has been added at the specified position of the list on its levels. deq->size is not incremented yet. */
+static void SkipInsert(const ud_t deq, const ud_element_t new_element, const ud_size_t index)
+{
+  struct ud_skip_index *skip = deq->skip;
+  ud_size_t size = deq->size, levels = SkipHead(new_element)->levels, old_levels = skip->levels;
+  ud_element_t predecessors[UD_SKIP_MAX_LEVELS];
+  ud_ssize_t positions[UD_SKIP_MAX_LEVELS];
+  if (index == 0u)
+  {
+    // the first elements of the levels above the new element are shifted
+    ++skip->front_shift;
+    for (ud_size_t level = 1u; level <= old_levels; ++level)
+    {
+      predecessors[level - 1u] = NULL;
+      positions[level - 1u] = -1;
+    }
+  }
+  else if (index == size)
+  {
+    // the gaps behind the last elements of the levels above the new element are shifted
+    ++skip->back_shift;
+    for (ud_size_t level = 1u; level <= old_levels; ++level)
+    {
+      predecessors[level - 1u] = skip->last[level - 1u];
+      positions[level - 1u] = (ud_ssize_t)(size - SkipLastGap(skip, level));
+    }
+  }
+  else
+    SkipSearch(deq, index, predecessors, positions);
+
+  for (ud_size_t level = 1u; level <= old_levels; ++level)
+  {
+    ud_element_t predecessor = predecessors[level - 1u];
+    ud_element_t successor = predecessor != NULL ? (index != size ? SkipLink(predecessor, level)->next : NULL) : skip->first[level - 1u];
+    if (level > levels)
+    {
+      if (index == 0u || index == size)
+        continue; // already shifted
+
+      if (predecessor == NULL)
+        SkipSetFirstPos(skip, level, SkipFirstPos(skip, level) + 1u);
+      else if (successor != NULL)
+        ++SkipLink(predecessor, level)->width;
+      else
+        SkipSetLastGap(skip, level, SkipLastGap(skip, level) + 1u);
+
+      continue;
+    }
+
+    struct ud_skip_link *link = SkipLink(new_element, level);
+    link->previous = predecessor;
+    link->next = successor;
+    if (successor != NULL)
+    {
+      // the successor has been moved one position behind
+      link->width = (predecessor != NULL ? (ud_size_t)positions[level - 1u] + SkipLink(predecessor, level)->width : SkipFirstPos(skip, level) - (index == 0u)) + 1u - index;
+      SkipLink(successor, level)->previous = new_element;
+    }
+    else
+    {
+      skip->last[level - 1u] = new_element;
+      SkipSetLastGap(skip, level, size - index);
+    }
+
+    if (predecessor != NULL)
+    {
+      SkipLink(predecessor, level)->next = new_element;
+      SkipLink(predecessor, level)->width = index - (ud_size_t)positions[level - 1u];
+    }
+    else
+    {
+      skip->first[level - 1u] = new_element;
+      SkipSetFirstPos(skip, level, index);
+    }
+  }
+
+  for (ud_size_t level = old_levels + 1u; level <= levels; ++level)
+  {
+    struct ud_skip_link *link = SkipLink(new_element, level);
+    link->previous = link->next = NULL;
+    skip->first[level - 1u] = skip->last[level - 1u] = new_element;
+    SkipSetFirstPos(skip, level, index);
+    SkipSetLastGap(skip, level, size - index);
+  }
+
+  if (levels > old_levels)
+    skip->levels = levels;
+}
+
+/* Unlinks an element at the specified position of the list from its levels. deq->size is not decremented yet. */
+static void SkipErase(const ud_t deq, const ud_element_t element, const ud_size_t index)
+{
+  struct ud_skip_index *skip = deq->skip;
+  ud_size_t size = deq->size, levels = SkipHead(element)->levels;
+  if (index == 0u)
+    --skip->front_shift; // the first elements of the levels above the element are shifted
+  else if (index == size - 1u)
+    --skip->back_shift; // the gaps behind the last elements of the levels above the element are shifted
+  else if (levels < skip->levels)
+  {
+    ud_element_t predecessors[UD_SKIP_MAX_LEVELS];
+    ud_ssize_t positions[UD_SKIP_MAX_LEVELS];
+    SkipSearch(deq, index, predecessors, positions);
+    for (ud_size_t level = levels + 1u; level <= skip->levels; ++level)
+    {
+      ud_element_t predecessor = predecessors[level - 1u];
+      if (predecessor == NULL)
+        SkipSetFirstPos(skip, level, SkipFirstPos(skip, level) - 1u);
+      else if (SkipLink(predecessor, level)->next != NULL)
+        --SkipLink(predecessor, level)->width;
+      else
+        SkipSetLastGap(skip, level, SkipLastGap(skip, level) - 1u);
+    }
+  }
+
+  for (ud_size_t level = 1u; level <= levels; ++level)
+  {
+    struct ud_skip_link *link = SkipLink(element, level);
+    if (link->previous != NULL)
+    {
+      SkipLink(link->previous, level)->next = link->next;
+      if (link->next != NULL)
+        SkipLink(link->previous, level)->width += link->width - 1u;
+    }
+    else
+    {
+      skip->first[level - 1u] = link->next;
+      if (link->next != NULL)
+        SkipSetFirstPos(skip, level, index + link->width - 1u);
+    }
+
+    if (link->next != NULL)
+      SkipLink(link->next, level)->previous = link->previous;
+    else
+    {
+      skip->last[level - 1u] = link->previous;
+      if (link->previous != NULL)
+        SkipSetLastGap(skip, level, size - 2u - index + SkipLink(link->previous, level)->width);
+    }
+  }
+
+  while (skip->levels != 0u && skip->first[skip->levels - 1u] == NULL)
+    --skip->levels;
+}
+
+/* Relinks all levels in the order of the list, after the list has been sorted or reversed. */
+static void SkipRebuild(const ud_t deq)
+{
+  struct ud_skip_index *skip = deq->skip;
+  ud_size_t last_pos[UD_SKIP_MAX_LEVELS];
+  for (ud_size_t level = 1u; level <= skip->levels; ++level)
+    skip->first[level - 1u] = skip->last[level - 1u] = NULL;
+
+  ud_size_t pos = 0u;
+  for (ud_element_t current_element = deq->head; current_element != NULL; current_element = current_element->next, ++pos)
+  {
+    for (ud_size_t level = 1u, levels = SkipHead(current_element)->levels; level <= levels; ++level)
+    {
+      struct ud_skip_link *link = SkipLink(current_element, level);
+      ud_element_t last = skip->last[level - 1u];
+      link->previous = last;
+      link->next = NULL;
+      if (last != NULL)
+      {
+        SkipLink(last, level)->next = current_element;
+        SkipLink(last, level)->width = pos - last_pos[level - 1u];
+      }
+      else
+      {
+        skip->first[level - 1u] = current_element;
+        SkipSetFirstPos(skip, level, pos);
+      }
+
+      skip->last[level - 1u] = current_element;
+      last_pos[level - 1u] = pos;
+    }
+  }
+
+  for (ud_size_t level = 1u; level <= skip->levels; ++level)
+    SkipSetLastGap(skip, level, deq->size - 1u - last_pos[level - 1u]);
+}
+
+/* Returns the position of an element of an indexed list. */
+static ud_size_t SkipRank(const ud_t deq, ud_element_t element)
+{
+  ud_size_t distance = 0u;
+  for ( ; SkipHead(element)->levels == 0u; element = element->previous, ++distance)
+  {
+    if (element->previous == NULL)
+      return distance;
+  }
+
+  // follow the highest level of each element back to the first element of the level, whose position is known
+  for (;;)
+  {
+    ud_size_t level = SkipHead(element)->levels;
+    ud_element_t previous = SkipLink(element, level)->previous;
+    if (previous == NULL)
+      return SkipFirstPos(deq->skip, level) + distance;
+
+    distance += SkipLink(previous, level)->width;
+    element = previous;
+  }
+}
+
+/* Returns the header in front of the links of the levels of an element of a hashed deque. */
+static union ud_hash_head *HashHead(const ud_element_t element)
+{
+  return (union ud_hash_head *)((char *)element - SkipTowerSize(SkipHead(element)->levels)) - 1;
+}
+
+/* Returns the index of the bucket for the hash. The bits are mixed in case the hash function doesn't distribute the lower bits well. */
+static ud_size_t HashBucket(const size_t hash_value, const ud_size_t count)
+{
+  uint64_t value = (uint64_t)hash_value * UINT64_C(0x9e3779b97f4a7c15);
+  return (value ^ (value >> 32)) & (count - 1u);
+}
+
+/* Moves the elements into a new table of the specified number of buckets. */
+static int HashResize(const ud_t deq, const ud_size_t new_count)
+{
+  struct ud_hash_index *hash = deq->hash;
+  ud_element_t *new_buckets = new_count <= SIZE_MAX / sizeof(ud_element_t) ? (ud_element_t *)Alloc(deq, (size_t)new_count * sizeof(ud_element_t)) : NULL;
+  if (new_buckets == NULL)
+    return 0;
+
+  for (ud_size_t i = 0u; i < new_count; ++i)
+    new_buckets[i] = NULL;
+
+  for (ud_size_t i = 0u; i < hash->count; ++i)
+  {
+    for (ud_element_t element = hash->buckets[i], next = NULL; element != NULL; element = next)
+    {
+      struct ud_hash_entry *entry = &HashHead(element)->entry;
+      ud_element_t *bucket = new_buckets + HashBucket(entry->hash, new_count);
+      next = entry->chain;
+      entry->chain = *bucket;
+      *bucket = element;
+    }
+  }
+
+  Free(deq, hash->buckets);
+  Account(deq, 0, ((ud_ssize_t)new_count - (ud_ssize_t)hash->count) * (ud_ssize_t)sizeof(ud_element_t), 0);
+  hash->buckets = new_buckets;
+  hash->count = new_count;
+  return 1;
+}
+
+/* Returns the number of buckets for the specified number of elements. */
+static ud_size_t HashFitCount(const ud_size_t number)
+{
+  ud_size_t count = UD_HASH_MIN_BUCKETS;
+  while (count < number && count <= UINT64_MAX / 2u)
+    count <<= 1u;
+
+  return count;
+}
+
+/* Adds an element that has been linked in the list to the hash table. The table grows if the elements outnumber the buckets. */
+static void HashAdd(const ud_t deq, const ud_element_t element)
+{
+  struct ud_hash_index *hash = deq->hash;
+  if (deq->size >= hash->count)
+    HashResize(deq, hash->count << 1u); // if the table can't grow, the buckets just get longer
+
+  struct ud_hash_entry *entry = &HashHead(element)->entry;
+  ud_element_t *bucket = hash->buckets + HashBucket(entry->hash = hash->hash_func(element->data), hash->count);
+  entry->chain = *bucket;
+  *bucket = element;
+}
+
+/* Removes an element from the hash table. */
+static void HashRemove(const ud_t deq, const ud_element_t element)
+{
+  struct ud_hash_entry *entry = &HashHead(element)->entry;
+  ud_element_t *link = deq->hash->buckets + HashBucket(entry->hash, deq->hash->count);
+  while (*link != element)
+    link = &HashHead(*link)->entry.chain;
+
+  *link = entry->chain;
+}
+
+/* Returns the first element of the list that contains the value, and its index. */
+static ud_element_t HashFind(const ud_t deq, const void *const p_data, ud_cmp_t cmp_callback_func, ud_size_t *p_index)
+{
+  struct ud_hash_index *hash = deq->hash;
+  ud_cmp_t cmp_func = hash->cmp_func != NULL ? hash->cmp_func : cmp_callback_func;
+  size_t hash_value = hash->hash_func(p_data);
+  ud_element_t found = NULL;
+  for (ud_element_t element = hash->buckets[HashBucket(hash_value, hash->count)]; element != NULL; element = HashHead(element)->entry.chain)
+  {
+    if (HashHead(element)->entry.hash == hash_value && cmp_func(p_data, element->data) == 0)
+    {
+      // equal values may be in the bucket more than once, the one closest to the begin of the list is found
+      ud_size_t index = SkipRank(deq, element);
+      if (found == NULL || index < *p_index)
+      {
+        found = element;
+        *p_index = index;
+      }
+    }
+  }
+
+  return found;
+}
+
+/* Returns the element at the specified position of the list. */
+static ud_element_t ListElementAt(const ud_t deq, const ud_size_t index)
+{
+  struct ud_finger *finger = &deq->finger;
+  ud_size_t tail_distance = deq->size - index - 1u;
+  ud_size_t finger_distance = finger->valid == 0 ? UINT64_MAX : (finger->index < index ? index - finger->index : finger->index - index);
+  ud_element_t current_element = NULL;
+  if (deq->skip != NULL && finger_distance > UD_FINGER_SKIP_DISTANCE)
+    current_element = SkipLocate(deq, index);
+  else if (finger_distance < index && finger_distance < tail_distance)
+  {
+    current_element = finger->element;
+    for (ud_size_t i = finger_distance; i-- > 0; )
+      current_element = finger->index > index ? current_element->previous : current_element->next;
+  }
+  else
+  {
+    current_element = tail_distance < index ? deq->tail : deq->head;
+    for (ud_size_t i = tail_distance < index ? tail_distance : index; i-- > 0; )
+      current_element = tail_distance < index ? current_element->previous : current_element->next;
+  }
+
+  finger->valid = 1;
+  finger->element = current_element;
+  finger->index = index;
+  return current_element;
+}
+
+/* Returns the address of the slot that holds the data pointer of the element at the specified index. */
+static void **BlockSlot(const struct ud_block_map *map, const ud_size_t index)
+{
+  ud_size_t pos = map->first + index;
+  return &map->blocks[pos / UD_BLOCK_SLOTS][pos % UD_BLOCK_SLOTS];
+}
+
+/* Makes sure that front_slots slots in front of the first element and back_slots slots behind the last element are available. */
+static int BlockMapReserve(const ud_t deq, const ud_size_t front_slots, const ud_size_t back_slots)
+{
+  struct ud_block_map *map = &deq->map;
+  ud_size_t size = deq->size;
+  // the slots must be addressable, and the map of up to four pointers per block of slots must not exceed the range of size_t
+  const ud_size_t max_slots = SIZE_MAX / sizeof(void *) / 4u;
+  if (front_slots > max_slots - size || back_slots > max_slots - size - front_slots)
+    return 0;
+
+  if (map->first < front_slots || map->count * UD_BLOCK_SLOTS - map->first - size < back_slots)
+  {
+    // Move the block pointers to a bigger or recentered map. The offset in the first block is kept so that the blocks don't need to be updated.
+    ud_size_t offset = map->first % UD_BLOCK_SLOTS;
+    ud_size_t front_blocks = front_slots > offset ? (front_slots - offset + UD_BLOCK_SLOTS - 1u) / UD_BLOCK_SLOTS : 0u;
+    ud_size_t back_blocks = (offset + size + back_slots + UD_BLOCK_SLOTS - 1u) / UD_BLOCK_SLOTS;
+    ud_size_t total = front_blocks + (back_blocks != 0u ? back_blocks : 1u);
+    ud_size_t new_count = map->count < 8u ? 8u : map->count;
+    while (new_count < 2u * total)
+      new_count <<= 1u;
+
+    ud_size_t new_first_block = (new_count - total) / 2u + front_blocks, old_first_block = map->first / UD_BLOCK_SLOTS;
+    for (ud_size_t i = 0u; i < map->count; ++i)
+    {
+      if (i + new_first_block - old_first_block >= new_count && map->blocks[i] != NULL) // wraps around for blocks that get out of range at the front
+      {
+        Account(deq, 0, 0, -(ud_ssize_t)(UD_BLOCK_SLOTS * sizeof(void *)));
+        Free(deq, map->blocks[i]); // unused block
+        map->blocks[i] = NULL;
+      }
+    }
+
+    if (new_count != map->count)
+    {
+      void ***new_blocks = (void ***)Realloc(deq, map->blocks, new_count * sizeof(void **));
+      if (new_blocks == NULL)
+        return 0;
+
+      memset(new_blocks + map->count, 0, (new_count - map->count) * sizeof(void **));
+      Account(deq, 0, (ud_ssize_t)((new_count - map->count) * sizeof(void **)), 0);
+      map->blocks = new_blocks;
+      map->count = new_count;
+    }
+
+    if (new_first_block > old_first_block)
+    {
+      memmove(map->blocks + (new_first_block - old_first_block), map->blocks, (new_count - (new_first_block - old_first_block)) * sizeof(void **));
+      memset(map->blocks, 0, (new_first_block - old_first_block) * sizeof(void **));
+    }
+    else if (new_first_block < old_first_block)
+    {
+      memmove(map->blocks, map->blocks + (old_first_block - new_first_block), (new_count - (old_first_block - new_first_block)) * sizeof(void **));
+      memset(map->blocks + new_count - (old_first_block - new_first_block), 0, (old_first_block - new_first_block) * sizeof(void **));
+    }
+
+    map->first = new_first_block * UD_BLOCK_SLOTS + offset;
+  }
+
+  if (front_slots + size + back_slots != 0u)
+  {
+    for (ud_size_t i = (map->first - front_slots) / UD_BLOCK_SLOTS, end = (map->first + size + back_slots - 1u) / UD_BLOCK_SLOTS; i <= end; ++i)
+    {
+      if (map->blocks[i] == NULL)
+      {
+        if ((map->blocks[i] = (void **)Alloc(deq, UD_BLOCK_SLOTS * sizeof(void *))) == NULL)
+          return 0;
+
+        Account(deq, 0, 0, (ud_ssize_t)(UD_BLOCK_SLOTS * sizeof(void *)));
+      }
+    }
+  }
+
+  return 1;
+}
+
+/* Inserts the data pointer at the specified index. The elements on the shorter side are shifted by one slot. */
+static int BlockMapInsert(const ud_t deq, const ud_size_t index, void *p_data)
+{
+  struct ud_block_map *map = &deq->map;
+  if (index < deq->size - index)
+  {
+    if (BlockMapReserve(deq, 1u, 0u) == 0)
+      return 0;
+
+    --map->first;
+    for (ud_size_t i = 0u; i < index; ++i)
+      *BlockSlot(map, i) = *BlockSlot(map, i + 1u);
+  }
+  else
+  {
+    if (BlockMapReserve(deq, 0u, 1u) == 0)
+      return 0;
+
+    for (ud_size_t i = deq->size; i > index; --i)
+      *BlockSlot(map, i) = *BlockSlot(map, i - 1u);
+  }
+
+  *BlockSlot(map, index) = p_data;
+  ++deq->size;
+  Account(deq, 0, (ud_ssize_t)sizeof(void *), -(ud_ssize_t)sizeof(void *));
+  return 1;
+}
+
+/* Removes the data pointer at the specified index and returns it. The elements on the shorter side are shifted by one slot. */
+static void *BlockMapErase(const ud_t deq, const ud_size_t index)
+{
+  struct ud_block_map *map = &deq->map;
+  void *data = *BlockSlot(map, index);
+  Account(deq, 0, -(ud_ssize_t)sizeof(void *), (ud_ssize_t)sizeof(void *));
+  if (index < --deq->size - index)
+  {
+    for (ud_size_t i = index; i > 0u; --i)
+      *BlockSlot(map, i) = *BlockSlot(map, i - 1u);
+
+    ++map->first;
+  }
+  else
+  {
+    for (ud_size_t i = index; i < deq->size; ++i)
+      *BlockSlot(map, i) = *BlockSlot(map, i + 1u);
+  }
+
+  return data;
+}
+
+/* Releases the blocks that don't contain elements and shrinks the block map to the remaining blocks. */
+static void BlockMapShrink(const ud_t deq)
+{
+  struct ud_block_map *map = &deq->map;
+  ud_size_t first_block = map->first / UD_BLOCK_SLOTS, last_block = deq->size != 0u ? (map->first + deq->size - 1u) / UD_BLOCK_SLOTS : first_block;
+  for (ud_size_t i = 0u; i < map->count; ++i)
+  {
+    if ((deq->size == 0u || i < first_block || i > last_block) && map->blocks[i] != NULL)
+    {
+      Account(deq, 0, 0, -(ud_ssize_t)(UD_BLOCK_SLOTS * sizeof(void *)));
+      Free(deq, map->blocks[i]);
+      map->blocks[i] = NULL;
+    }
+  }
+
+  if (deq->size == 0u)
+  {
+    Account(deq, 0, -(ud_ssize_t)(map->count * sizeof(void **)), 0);
+    Free(deq, map->blocks);
+    map->blocks = NULL;
+    map->count = map->first = 0u;
+    return;
+  }
+
+  ud_size_t new_count = last_block - first_block + 1u;
+  memmove(map->blocks, map->blocks + first_block, new_count * sizeof(void **));
+  memset(map->blocks + new_count, 0, (map->count - new_count) * sizeof(void **));
+  map->first -= first_block * UD_BLOCK_SLOTS;
+  void ***new_blocks = (void ***)Realloc(deq, map->blocks, new_count * sizeof(void **));
+  if (new_blocks != NULL) // otherwise the bigger map is kept
+  {
+    Account(deq, 0, -(ud_ssize_t)((map->count - new_count) * sizeof(void **)), 0);
+    map->blocks = new_blocks;
+    map->count = new_count;
+  }
+}
+
+/* Returns the index of the pending run that is to be merged with the run above it, or -1 if the runs stay pending until the next run is
+   added. Runs are merged until their lengths grow faster than the Fibonacci numbers from the top to the bottom (like TimSort), the run
+   below is merged first if it is shorter than the top run. All runs are merged after the last run was added. */
+static int NextMerge(const ud_size_t *run_length, const int runs, const int last)
+{
+  int k = runs - 2;
+  if (k < 0)
+    return -1;
+
+  if (last != 0 || (k > 0 && run_length[k - 1] <= run_length[k] + run_length[k + 1]) || (k > 1 && run_length[k - 2] <= run_length[k - 1] + run_length[k]))
+    return k > 0 && run_length[k - 1] < run_length[k + 1] ? k - 1 : k;
+
+  return run_length[k] <= run_length[k + 1] ? k : -1;
+}
+
+/* Defines the stable natural merge sort of an array of data pointers (the functions Gallop, MergeRuns, and SortItems with the appended
+   suffix), and the merge of two sorted arrays that UDSortParallel() uses (MergeItems with the appended suffix), that compare the values
+   using cmp_func. The generic functions call the comparison function passed to cmp_callback_func, the functions specialized for a type
+   call the comparison function of the type directly, so that the compiler can inline the comparisons. */
+#define UD_DEFINE_SORT_ITEMS(suffix, cmp_func) \
+/* Returns the number of leading items whose values come before the key (or, if inclusive != 0, don't come after the key). The range is \
+   narrowed by an exponential search, so that the number of comparisons grows with the logarithm of the result. */ \
+static ud_size_t Gallop##suffix(const void *key, void **items, const ud_size_t count, ud_cmp_t cmp_callback_func, const int inclusive) \
+{ \
+  (void)cmp_callback_func; \
+  ud_size_t lo = 0u, hi = 1u; \
+  while (hi <= count && (inclusive != 0 ? cmp_func(items[hi - 1u], key) < 1 : cmp_func(items[hi - 1u], key) < 0)) \
+  { \
+    lo = hi; \
+    hi <<= 1u; \
+  } \
+\
+  if (hi > count) \
+    hi = count; \
+\
+  while (lo < hi) \
+  { \
+    ud_size_t mid = lo + (hi - lo) / 2u; \
+    (inclusive != 0 ? cmp_func(items[mid], key) < 1 : cmp_func(items[mid], key) < 0) ? (lo = mid + 1u) : (hi = mid); \
+  } \
+\
+  return lo; \
+} \
+\
+/* Merges two adjacent sorted runs of items. Items of the first run that don't come after the first item of the second run and items of the \
+   second run that don't come before the last item of the first run are already in place. The rest of the first run is moved to the buffer. \
+   A run that supplied UD_SORT_MIN_GALLOP items in a row is searched for the number of items it supplies next. */ \
+static void MergeRuns##suffix(void **items, ud_size_t first_count, ud_size_t second_count, void **buffer, ud_cmp_t cmp_callback_func) \
+{ \
+  (void)cmp_callback_func; \
+  ud_size_t skip = Gallop##suffix(items[first_count], items, first_count, cmp_callback_func, 1); \
+  items += skip; \
+  first_count -= skip; \
+  if (first_count == 0u) \
+    return; \
+\
+  second_count = Gallop##suffix(items[first_count - 1u], items + first_count, second_count, cmp_callback_func, 0); \
+  memcpy(buffer, items, first_count * sizeof(void *)); \
+  void **left = buffer, **left_end = buffer + first_count, **right = items + first_count, **right_end = right + second_count, **dest = items; \
+  for (ud_size_t l_wins = 0u, r_wins = 0u; left < left_end && right < right_end; ) \
+  { \
+    if (l_wins >= UD_SORT_MIN_GALLOP || r_wins >= UD_SORT_MIN_GALLOP) \
+    { \
+      /* the right items are moved towards the begin of the items, the destination may overlap */ \
+      ud_size_t count = l_wins != 0u ? Gallop##suffix(*right, left, (ud_size_t)(left_end - left), cmp_callback_func, 1) : Gallop##suffix(*left, right, (ud_size_t)(right_end - right), cmp_callback_func, 0); \
+      l_wins != 0u ? memcpy(dest, left, count * sizeof(void *)) : memmove(dest, right, count * sizeof(void *)); \
+      l_wins != 0u ? (left += count) : (right += count); \
+      dest += count; \
+      l_wins = r_wins = 0u; \
+    } \
+    else \
+    { \
+      /* the merge step is written without branches on the result of the comparison */ \
+      int take_right = cmp_func(*left, *right) > 0; \
+      *dest++ = take_right != 0 ? *right : *left; \
+      right += take_right; \
+      left += !take_right; \
+      l_wins = take_right != 0 ? 0u : l_wins + 1u; \
+      r_wins = take_right != 0 ? r_wins + 1u : 0u; \
+    } \
+  } \
+\
+  /* remaining right items are already in place */ \
+  memcpy(dest, left, (size_t)(left_end - left) * sizeof(void *)); \
+} \
+\
+/* Stable natural merge sort of an array of data pointers, using a buffer of the same number of items. Ascending and strictly descending \
+   runs are detected (the latter are reversed), runs shorter than 32 to 64 items are extended by a binary insertion sort, and the runs are \
+   merged in the order that keeps the lengths of pending runs balanced (like TimSort). Thus, presorted items and items that consist of a few \
+   sorted sequences take O(n) comparisons. */ \
+static void SortItems##suffix(void **items, const ud_size_t count, void **buffer, ud_cmp_t cmp_callback_func) \
+{ \
+  (void)cmp_callback_func; \
+  ud_size_t min_run = count, odd = 0u; \
+  for (; min_run >= 64u; min_run >>= 1u) \
+    odd |= min_run & 1u; \
+\
+  min_run += odd; \
+  ud_size_t run_start[UD_SORT_MAX_RUNS], run_length[UD_SORT_MAX_RUNS]; \
+  int runs = 0; \
+  for (ud_size_t lo = 0u, hi = 0u; lo < count; lo = hi) \
+  { \
+    hi = lo + 1u; \
+    if (hi < count) \
+    { \
+      if (cmp_func(items[hi++], items[lo]) < 0) \
+      { \
+        for (; hi < count && cmp_func(items[hi], items[hi - 1u]) < 0; ++hi); \
+        for (ud_size_t l = lo, r = hi - 1u; l < r; ++l, --r) \
+        { \
+          void *tmp = items[l]; \
+          items[l] = items[r]; \
+          items[r] = tmp; \
+        } \
+      } \
+      else \
+        for (; hi < count && cmp_func(items[hi], items[hi - 1u]) > -1; ++hi); \
+    } \
+\
+    for (ud_size_t end = count - lo > min_run ? lo + min_run : count; hi < end; ++hi) \
+    { \
+      void *item = items[hi]; \
+      ud_size_t pos = lo, end_pos = hi; \
+      while (pos < end_pos) \
+      { \
+        ud_size_t mid = pos + (end_pos - pos) / 2u; \
+        cmp_func(items[mid], item) < 1 ? (pos = mid + 1u) : (end_pos = mid); \
+      } \
+\
+      memmove(items + pos + 1u, items + pos, (hi - pos) * sizeof(void *)); \
+      items[pos] = item; \
+    } \
+\
+    run_start[runs] = lo; \
+    run_length[runs++] = hi - lo; \
+    for (int k = NextMerge(run_length, runs, hi == count); k >= 0; k = NextMerge(run_length, runs, hi == count)) \
+    { \
+      MergeRuns##suffix(items + run_start[k], run_length[k], run_length[k + 1], buffer, cmp_callback_func); \
+      run_length[k] += run_length[k + 1]; \
+      for (int i = k + 1; i < runs - 1; ++i) \
+      { \
+        run_start[i] = run_start[i + 1]; \
+        run_length[i] = run_length[i + 1]; \
+      } \
+\
+      --runs; \
+    } \
+  } \
+} \
+\
+/* Merges two sorted ranges of items into the destination. Items of the first range come first if the values are equal. */ \
+static void MergeItems##suffix(void **first, const ud_size_t first_count, void **second, const ud_size_t second_count, void **dest, \
+                               ud_cmp_t cmp_callback_func) \
+{ \
+  (void)cmp_callback_func; \
+  ud_size_t l = 0u, r = 0u; \
+  while (l < first_count && r < second_count) \
+    *dest++ = cmp_func(first[l], second[r]) < 1 ? first[l++] : second[r++]; \
+\
+  memcpy(dest, first + l, (size_t)(first_count - l) * sizeof(void *)); \
+  memcpy(dest + (first_count - l), second + r, (size_t)(second_count - r) * sizeof(void *)); \
+}
+
+UD_DEFINE_SORT_ITEMS(, cmp_callback_func)
+UD_DEFINE_SORT_ITEMS(AscC, CmpAscC)
+UD_DEFINE_SORT_ITEMS(DescC, CmpDescC)
+UD_DEFINE_SORT_ITEMS(AscSC, CmpAscSC)
+UD_DEFINE_SORT_ITEMS(DescSC, CmpDescSC)
+UD_DEFINE_SORT_ITEMS(AscUC, CmpAscUC)
+UD_DEFINE_SORT_ITEMS(DescUC, CmpDescUC)
+UD_DEFINE_SORT_ITEMS(AscS, CmpAscS)
+UD_DEFINE_SORT_ITEMS(DescS, CmpDescS)
+UD_DEFINE_SORT_ITEMS(AscUS, CmpAscUS)
+UD_DEFINE_SORT_ITEMS(DescUS, CmpDescUS)
+UD_DEFINE_SORT_ITEMS(AscI, CmpAscI)
+UD_DEFINE_SORT_ITEMS(DescI, CmpDescI)
+UD_DEFINE_SORT_ITEMS(AscUI, CmpAscUI)
+UD_DEFINE_SORT_ITEMS(DescUI, CmpDescUI)
+UD_DEFINE_SORT_ITEMS(AscL, CmpAscL)
+UD_DEFINE_SORT_ITEMS(DescL, CmpDescL)
+UD_DEFINE_SORT_ITEMS(AscUL, CmpAscUL)
+UD_DEFINE_SORT_ITEMS(DescUL, CmpDescUL)
+UD_DEFINE_SORT_ITEMS(AscLL, CmpAscLL)
+UD_DEFINE_SORT_ITEMS(DescLL, CmpDescLL)
+UD_DEFINE_SORT_ITEMS(AscULL, CmpAscULL)
+UD_DEFINE_SORT_ITEMS(DescULL, CmpDescULL)
+UD_DEFINE_SORT_ITEMS(AscF, CmpAscF)
+UD_DEFINE_SORT_ITEMS(DescF, CmpDescF)
+UD_DEFINE_SORT_ITEMS(AscD, CmpAscD)
+UD_DEFINE_SORT_ITEMS(DescD, CmpDescD)
+UD_DEFINE_SORT_ITEMS(AscLD, CmpAscLD)
+UD_DEFINE_SORT_ITEMS(DescLD, CmpDescLD)
+UD_DEFINE_SORT_ITEMS(AscStr, CmpAscStr)
+UD_DEFINE_SORT_ITEMS(DescStr, CmpDescStr)
+UD_DEFINE_SORT_ITEMS(AscWStr, CmpAscWStr)
+UD_DEFINE_SORT_ITEMS(DescWStr, CmpDescWStr)
+
+/* Sorts an array of data pointers using a temporary buffer. */
+static int SortDataArray(const ud_t deq, void **items, const ud_size_t count, ud_cmp_t cmp_callback_func, void (*sort_items)(void **, const ud_size_t, void **, ud_cmp_t))
+{
+  void **buffer = (void **)Alloc(deq, count * sizeof(void *));
+  if (buffer == NULL)
+    return 0;
+
+  sort_items(items, count, buffer, cmp_callback_func);
+  Free(deq, buffer);
+  return 1;
+}
+
+/* Merges the second run into the first run of a list, both runs end with a NULL link. The elements of the first run come first if the
+   values are equal. If the last value of the first run doesn't come after the first value of the second run, the runs are just concatenated. */
+static void MergeListRuns(struct ud_run *first, const struct ud_run *second, ud_cmp_t cmp_callback_func)
+{
+  if (cmp_callback_func(first->tail->data, second->head->data) < 1)
+    first->tail->next = second->head;
+  else
+  {
+    ud_element_t left = first->head, right = second->head, back = NULL;
+    while (left != NULL && right != NULL)
+    {
+      ud_element_t picked = cmp_callback_func(left->data, right->data) < 1 ? left : right;
+      picked == left ? (left = left->next) : (right = right->next);
+      back == NULL ? (first->head = picked) : (back->next = picked);
+      back = picked;
+    }
+
+    back->next = left != NULL ? left : right;
+  }
+
+  // the last element of the first run is followed by other elements unless the rest of the first run was appended
+  if (first->tail->next != NULL)
+    first->tail = second->tail;
+}
+
+/* Releases the memory of a value of a deque that uses the block map. */
+static void BlockMapFreeData(const ud_t deq, void *p_data)
+{
+  if (deq->strings.page_size != 0u)
+  {
+    StrRelease(deq, p_data);
+    return;
+  }
+
+  union ud_value_head *head = (union ud_value_head *)p_data - 1;
+  Account(deq, -(ud_ssize_t)head->size, -(ud_ssize_t)sizeof(union ud_value_head), 0);
+  Free(deq, head);
+}
+
+/* Allocates the memory for a copy of the data and inserts its pointer at the specified index. */
+static void *BlockMapNewData(const ud_t deq, const ud_size_t index, const void *const p_data, const size_t data_size)
+{
+  void *new_data = NULL;
+  if (deq->strings.page_size != 0u)
+    new_data = StrAlloc(deq, data_size);
+  else
+  {
+    union ud_value_head *head = (union ud_value_head *)Alloc(deq, sizeof(union ud_value_head) + data_size);
+    if (head != NULL)
+    {
+      head->size = data_size;
+      Account(deq, (ud_ssize_t)data_size, (ud_ssize_t)sizeof(union ud_value_head), 0);
+      new_data = head + 1;
+    }
+  }
+
+  if (new_data == NULL || BlockMapInsert(deq, index, new_data) == 0)
+  {
+    deq->err = 1;
+    if (new_data != NULL)
+      BlockMapFreeData(deq, new_data);
+
+    return NULL;
+  }
+
+  deq->err = 0;
+  return memcpy(new_data, p_data, data_size);
+}
+
+/* Returns the address of the value of the element at the specified index in the ring buffer. */
+static unsigned char *RingSlot(const ud_t deq, const ud_size_t index)
+{
+  ud_size_t pos = deq->ring.first + index;
+  return deq->ring.buffer + (pos < deq->ring.capacity ? pos : pos - deq->ring.capacity) * deq->elem_size;
+}
+
+/* Changes the capacity of the ring buffer. The new capacity must not be less than the number of elements. */
+static int RingResize(const ud_t deq, const ud_size_t new_capacity)
+{
+  struct ud_ring *ring = &deq->ring;
+  size_t elem_size = deq->elem_size;
+  if (new_capacity == ring->capacity)
+    return 1;
+
+  if (new_capacity > SIZE_MAX / elem_size)
+    return 0;
+
+  if (new_capacity < ring->capacity)
+  {
+    // copy the values to the begin of a smaller buffer
+    unsigned char *new_buffer = new_capacity != 0u ? (unsigned char *)Alloc(deq, new_capacity * elem_size) : NULL;
+    if (new_capacity != 0u && new_buffer == NULL)
+      return 0;
+
+    ud_size_t front_count = ring->capacity - ring->first < deq->size ? ring->capacity - ring->first : deq->size;
+    if (deq->size != 0u)
+    {
+      memcpy(new_buffer, ring->buffer + ring->first * elem_size, front_count * elem_size);
+      memcpy(new_buffer + front_count * elem_size, ring->buffer, (deq->size - front_count) * elem_size);
+    }
+
+    Free(deq, ring->buffer);
+    Account(deq, 0, 0, -(ud_ssize_t)((ring->capacity - new_capacity) * elem_size));
+    ring->buffer = new_buffer;
+    ring->capacity = new_capacity;
+    ring->first = 0u;
+    return 1;
+  }
+
+  unsigned char *new_buffer = (unsigned char *)Realloc(deq, ring->buffer, new_capacity * elem_size);
+  if (new_buffer == NULL)
+    return 0;
+
+  if (ring->first + deq->size > ring->capacity)
+  {
+    ud_size_t wrapped_count = ring->first + deq->size - ring->capacity;
+    if (wrapped_count <= new_capacity - ring->capacity)
+    {
+      // move the values that wrapped around to the begin of the buffer behind the old end of the buffer
+      memcpy(new_buffer + ring->capacity * elem_size, new_buffer, wrapped_count * elem_size);
+    }
+    else
+    {
+      // move the values in front of the old end of the buffer to the new end of the buffer
+      memmove(new_buffer + (ring->first + new_capacity - ring->capacity) * elem_size, new_buffer + ring->first * elem_size, (ring->capacity - ring->first) * elem_size);
+      ring->first += new_capacity - ring->capacity;
+    }
+  }
+
+  Account(deq, 0, 0, (ud_ssize_t)((new_capacity - ring->capacity) * elem_size));
+  ring->buffer = new_buffer;
+  ring->capacity = new_capacity;
+  return 1;
+}
+
+/* Copies the value into the ring buffer at the specified index. The values on the shorter side are shifted by one slot. */
+static void *RingInsert(const ud_t deq, ud_size_t index, const void *const p_data, const size_t data_size)
+{
+  struct ud_ring *ring = &deq->ring;
+  if (data_size > deq->elem_size || (deq->size == ring->capacity && (ring->bounded == 0 ? RingResize(deq, ring->capacity != 0u ? ring->capacity << 1u : 16u) == 0 : ring->policy == UD_OVERFLOW_FAIL)))
+  {
+    deq->err = 1;
+    return NULL;
+  }
+
+  if (deq->size == ring->capacity)
+  {
+    if (ring->policy == UD_OVERFLOW_DROP_NEWEST)
+    {
+      deq->err = 0;
+      return NULL;
+    }
+
+    // UD_OVERFLOW_OVERWRITE_OLDEST, the oldest element is on the opposite side of where the new element is added
+    --deq->size;
+    Account(deq, -(ud_ssize_t)deq->elem_size, 0, (ud_ssize_t)deq->elem_size);
+    if (index != 0u)
+    {
+      ring->first = ring->first + 1u < ring->capacity ? ring->first + 1u : 0u;
+      --index;
+    }
+  }
+
+  if (index < deq->size - index)
+  {
+    ring->first = (ring->first != 0u ? ring->first : ring->capacity) - 1u;
+    for (ud_size_t i = 0u; i < index; ++i)
+      memcpy(RingSlot(deq, i), RingSlot(deq, i + 1u), deq->elem_size);
+  }
+  else
+  {
+    for (ud_size_t i = deq->size; i > index; --i)
+      memcpy(RingSlot(deq, i), RingSlot(deq, i - 1u), deq->elem_size);
+  }
+
+  ++deq->size;
+  Account(deq, (ud_ssize_t)deq->elem_size, 0, -(ud_ssize_t)deq->elem_size);
+  unsigned char *slot = RingSlot(deq, index);
+  memset(slot + data_size, 0, deq->elem_size - data_size);
+  deq->err = 0;
+  return memcpy(slot, p_data, data_size);
+}
+
+/* Copies the value at the specified index to the spare buffer and removes it from the ring buffer. */
+static void *RingErase(const ud_t deq, const ud_size_t index)
+{
+  struct ud_ring *ring = &deq->ring;
+  memcpy(deq->spare, RingSlot(deq, index), deq->elem_size);
+  Account(deq, -(ud_ssize_t)deq->elem_size, 0, (ud_ssize_t)deq->elem_size);
+  if (index < --deq->size - index)
+  {
+    for (ud_size_t i = index; i > 0u; --i)
+      memcpy(RingSlot(deq, i), RingSlot(deq, i - 1u), deq->elem_size);
+
+    ring->first = ring->first + 1u < ring->capacity ? ring->first + 1u : 0u;
+  }
+  else
+  {
+    for (ud_size_t i = index; i < deq->size; ++i)
+      memcpy(RingSlot(deq, i), RingSlot(deq, i + 1u), deq->elem_size);
+  }
+
+  return deq->spare;
+}
+
+/* Access, insert and erase elements by index in deques that use the block map or the ring buffer. */
+static int IsIndexed(const ud_t deq)
+{
+  return deq->storage == UD_STORAGE_BLOCKS || deq->storage == UD_STORAGE_RING;
+}
+
+static void *IndexedData(const ud_t deq, const ud_size_t index)
+{
+  return deq->storage == UD_STORAGE_BLOCKS ? *BlockSlot(&deq->map, index) : (void *)RingSlot(deq, index);
+}
+
+static void *IndexedInsert(const ud_t deq, const ud_size_t index, const void *const p_data, const size_t data_size)
+{
+  void *new_data = deq->storage == UD_STORAGE_BLOCKS ? BlockMapNewData(deq, index, p_data, data_size) : RingInsert(deq, index, p_data, data_size);
+  if (new_data != NULL && deq->filter != NULL)
+    FilterAdd(deq, new_data);
+
+  return new_data;
+}
+
+static void *IndexedErase(const ud_t deq, const ud_size_t index)
+{
+  deq->err = 0;
+  return deq->storage == UD_STORAGE_BLOCKS ? BlockMapErase(deq, index) : RingErase(deq, index);
+}
+
+/* Access the value and the links of a node in the node table. */
+static unsigned char *CompactNode(const ud_t deq, const uint32_t index)
+{
+  return deq->compact.table + (size_t)index * deq->compact.node_size;
+}
+
+static uint32_t *CompactLinks(const ud_t deq, const uint32_t index)
+{
+  return (uint32_t *)(CompactNode(deq, index) + deq->compact.links_offset);
+}
+
+/* Returns the index of the node at the specified position in the deque. */
+static uint32_t CompactAt(const ud_t deq, const ud_size_t index)
+{
+  struct ud_finger *finger = &deq->finger;
+  ud_size_t tail_distance = deq->size - index - 1u;
+  ud_size_t finger_distance = finger->valid == 0 ? UINT64_MAX : (finger->index < index ? index - finger->index : finger->index - index);
+  uint32_t current_node = UD_NIL_NODE;
+  if (finger_distance < index && finger_distance < tail_distance)
+  {
+    current_node = finger->node;
+    for (ud_size_t i = finger_distance; i-- > 0; )
+      current_node = CompactLinks(deq, current_node)[finger->index > index ? UD_LINK_PREVIOUS : UD_LINK_NEXT];
+  }
+  else
+  {
+    current_node = tail_distance < index ? deq->compact.tail : deq->compact.head;
+    for (ud_size_t i = tail_distance < index ? tail_distance : index; i-- > 0; )
+      current_node = CompactLinks(deq, current_node)[tail_distance < index ? UD_LINK_PREVIOUS : UD_LINK_NEXT];
+  }
+
+  finger->valid = 1;
+  finger->node = current_node;
+  finger->index = index;
+  return current_node;
+}
+
+/* Keeps the index of the finger up to date if an element is inserted at the specified index or is about to be removed from there.
+   The finger moves to the next element if the element it refers to is removed. */
+static void FingerInsert(const ud_t deq, const ud_size_t index)
+{
+  if (deq->finger.valid != 0 && deq->finger.index >= index)
+    ++deq->finger.index;
+}
+
+static void FingerErase(const ud_t deq, const ud_size_t index)
+{
+  struct ud_finger *finger = &deq->finger;
+  if (finger->valid == 0 || finger->index < index)
+    return;
+
+  if (finger->index > index)
+    --finger->index;
+  else if (deq->storage == UD_STORAGE_COMPACT)
+    finger->valid = (finger->node = CompactLinks(deq, finger->node)[UD_LINK_NEXT]) != UD_NIL_NODE;
+  else
+    finger->valid = (finger->element = finger->element->next) != NULL;
+}
+
+/* Unlinks the element at the specified index from the list, the levels of the skip list, and the hash table. The element is not released. */
+static void UnlinkElement(const ud_t deq, const ud_element_t element, const ud_size_t index)
+{
+  if (deq->skip != NULL)
+    SkipErase(deq, element, index);
+
+  if (deq->hash != NULL)
+    HashRemove(deq, element);
+
+  FingerErase(deq, index);
+  --deq->size;
+  element->previous != NULL ? (element->previous->next = element->next) : (deq->head = element->next);
+  element->next != NULL ? (element->next->previous = element->previous) : (deq->tail = element->previous);
+}
+
+/* Grows the table to the specified number of nodes. */
+static int CompactGrow(const ud_t deq, const uint32_t new_capacity)
+{
+  struct ud_compact *compact = &deq->compact;
+  if (new_capacity > SIZE_MAX / compact->node_size)
+    return 0;
+
+  unsigned char *new_table = (unsigned char *)Realloc(deq, compact->table, (size_t)new_capacity * compact->node_size);
+  if (new_table == NULL)
+    return 0;
+
+  Account(deq, 0, 0, (ud_ssize_t)((size_t)(new_capacity - compact->capacity) * compact->node_size));
+  compact->table = new_table;
+  compact->capacity = new_capacity;
+  return 1;
+}
+
+/* Copies the nodes in use to a table that has no free nodes. The nodes are renumbered in the order of the list. */
+static int CompactShrink(const ud_t deq)
+{
+  struct ud_compact *compact = &deq->compact;
+  if (compact->capacity == deq->size)
+    return 1;
+
+  unsigned char *new_table = deq->size != 0u ? (unsigned char *)Alloc(deq, (size_t)deq->size * compact->node_size) : NULL;
+  if (deq->size != 0u && new_table == NULL)
+    return 0;
+
+  uint32_t index = 0u;
+  for (uint32_t node = compact->head; node != UD_NIL_NODE; node = CompactLinks(deq, node)[UD_LINK_NEXT], ++index)
+  {
+    unsigned char *new_node = new_table + (size_t)index * compact->node_size;
+    uint32_t *links = (uint32_t *)(new_node + compact->links_offset);
+    memcpy(new_node, CompactNode(deq, node), deq->elem_size);
+    links[UD_LINK_PREVIOUS] = index != 0u ? index - 1u : UD_NIL_NODE;
+    links[UD_LINK_NEXT] = index + 1u != deq->size ? index + 1u : UD_NIL_NODE;
+  }
+
+  Free(deq, compact->table);
+  Account(deq, 0, 0, -(ud_ssize_t)((size_t)(compact->capacity - deq->size) * compact->node_size));
+  compact->table = new_table;
+  compact->head = deq->size != 0u ? 0u : UD_NIL_NODE;
+  compact->tail = deq->size != 0u ? (uint32_t)deq->size - 1u : UD_NIL_NODE;
+  compact->free_list = UD_NIL_NODE;
+  compact->used = compact->capacity = (uint32_t)deq->size;
+  deq->finger.valid = 0;
+  return 1;
+}
+
+/* Takes a node from the free list or from the unused part of the table, copies the value into it and links it before the specified node.
+   The index is the position of the new node in the deque. */
+static void *CompactInsert(const ud_t deq, const uint32_t next_node, const ud_size_t index, const void *const p_data, const size_t data_size)
+{
+  struct ud_compact *compact = &deq->compact;
+  if (data_size > deq->elem_size || (compact->free_list == UD_NIL_NODE && compact->used == compact->capacity && compact->capacity == UD_NIL_NODE))
+  {
+    deq->err = 1;
+    return NULL;
+  }
+
+  uint32_t new_node = compact->free_list;
+  if (new_node != UD_NIL_NODE)
+    compact->free_list = CompactLinks(deq, new_node)[UD_LINK_NEXT];
+  else
+  {
+    if (compact->used == compact->capacity && CompactGrow(deq, compact->capacity == 0u ? 16u : (compact->capacity < UD_NIL_NODE / 2u ? compact->capacity * 2u : UD_NIL_NODE)) == 0)
+    {
+      deq->err = 1;
+      return NULL;
+    }
+
+    new_node = compact->used++;
+  }
+
+  uint32_t *links = CompactLinks(deq, new_node);
+  links[UD_LINK_NEXT] = next_node;
+  links[UD_LINK_PREVIOUS] = next_node != UD_NIL_NODE ? CompactLinks(deq, next_node)[UD_LINK_PREVIOUS] : compact->tail;
+  links[UD_LINK_PREVIOUS] != UD_NIL_NODE ? (CompactLinks(deq, links[UD_LINK_PREVIOUS])[UD_LINK_NEXT] = new_node) : (compact->head = new_node);
+  next_node != UD_NIL_NODE ? (CompactLinks(deq, next_node)[UD_LINK_PREVIOUS] = new_node) : (compact->tail = new_node);
+  FingerInsert(deq, index);
+  ++deq->size;
+  Account(deq, (ud_ssize_t)deq->elem_size, (ud_ssize_t)(compact->node_size - deq->elem_size), -(ud_ssize_t)compact->node_size);
+  unsigned char *value = CompactNode(deq, new_node);
+  memset(value + data_size, 0, deq->elem_size - data_size);
+  memcpy(value, p_data, data_size);
+  if (deq->filter != NULL)
+    FilterAdd(deq, value);
+
+  deq->err = 0;
+  return value;
+}
+
+/* Unlinks the node at the specified index, copies its value to the spare buffer and adds the node to the free list. */
+static void *CompactErase(const ud_t deq, const uint32_t node, const ud_size_t index)
+{
+  struct ud_compact *compact = &deq->compact;
+  FingerErase(deq, index);
+  uint32_t *links = CompactLinks(deq, node);
+  links[UD_LINK_PREVIOUS] != UD_NIL_NODE ? (CompactLinks(deq, links[UD_LINK_PREVIOUS])[UD_LINK_NEXT] = links[UD_LINK_NEXT]) : (compact->head = links[UD_LINK_NEXT]);
+  links[UD_LINK_NEXT] != UD_NIL_NODE ? (CompactLinks(deq, links[UD_LINK_NEXT])[UD_LINK_PREVIOUS] = links[UD_LINK_PREVIOUS]) : (compact->tail = links[UD_LINK_PREVIOUS]);
+  links[UD_LINK_NEXT] = compact->free_list;
+  compact->free_list = node;
+  --deq->size;
+  Account(deq, -(ud_ssize_t)deq->elem_size, -(ud_ssize_t)(compact->node_size - deq->elem_size), (ud_ssize_t)compact->node_size);
+  deq->err = 0;
+  return memcpy(deq->spare, CompactNode(deq, node), deq->elem_size);
+}
+
+/* Copies the data pointers of the elements to the array, in the order of the elements. */
+static void GatherData(const ud_t deq, void **items)
+{
+  if (IsIndexed(deq))
+  {
+    for (ud_size_t i = 0u; i < deq->size; ++i)
+      items[i] = IndexedData(deq, i);
+  }
+  else if (deq->storage == UD_STORAGE_COMPACT)
+  {
+    uint32_t node = deq->compact.head;
+    for (ud_size_t i = 0u; i < deq->size; ++i, node = CompactLinks(deq, node)[UD_LINK_NEXT])
+      items[i] = CompactNode(deq, node);
+  }
+  else
+  {
+    ud_element_t element = deq->head;
+    for (ud_size_t i = 0u; i < deq->size; ++i, element = element->next)
+      items[i] = element->data;
+  }
+}
+
+/* Rearranges the elements in the order of the array of their data pointers. The values of a deque that uses the ring buffer are copied into
+   the new buffer passed, which replaces the ring buffer. */
+static void ApplyOrder(const ud_t deq, void **items, unsigned char *new_buffer)
+{
+  if (deq->storage == UD_STORAGE_BLOCKS)
+  {
+    for (ud_size_t i = 0u; i < deq->size; ++i)
+      *BlockSlot(&deq->map, i) = items[i];
+  }
+  else if (deq->storage == UD_STORAGE_RING)
+  {
+    for (ud_size_t i = 0u; i < deq->size; ++i)
+      memcpy(new_buffer + i * deq->elem_size, items[i], deq->elem_size);
+
+    Free(deq, deq->ring.buffer);
+    deq->ring.buffer = new_buffer;
+    deq->ring.first = 0u;
+  }
+  else if (deq->storage == UD_STORAGE_COMPACT)
+  {
+    // the nodes are relinked in sorted order
+    uint32_t previous = UD_NIL_NODE;
+    for (ud_size_t i = 0u; i < deq->size; ++i)
+    {
+      uint32_t node = (uint32_t)(((unsigned char *)items[i] - deq->compact.table) / deq->compact.node_size);
+      CompactLinks(deq, node)[UD_LINK_PREVIOUS] = previous;
+      previous != UD_NIL_NODE ? (CompactLinks(deq, previous)[UD_LINK_NEXT] = node) : (deq->compact.head = node);
+      previous = node;
+    }
+
+    CompactLinks(deq, previous)[UD_LINK_NEXT] = UD_NIL_NODE;
+    deq->compact.tail = previous;
+    deq->finger.valid = 0;
+  }
+  else
+  {
+    // the elements are relinked in sorted order
+    ud_element_t previous = NULL;
+    for (ud_size_t i = 0u; i < deq->size; ++i)
+    {
+      ud_element_t element = DataElement(items[i]);
+      element->previous = previous;
+      previous != NULL ? (previous->next = element) : (deq->head = element);
+      previous = element;
+    }
+
+    previous->next = NULL;
+    deq->tail = previous;
+    deq->finger.valid = 0;
+    if (deq->skip != NULL)
+      SkipRebuild(deq);
+  }
+}
+
+/* Returns the value at the specified index in any kind of deque. */
+static void *DataAt(const ud_t deq, const ud_size_t index)
+{
+  if (IsIndexed(deq))
+    return IndexedData(deq, index);
+
+  return deq->storage == UD_STORAGE_COMPACT ? CompactNode(deq, CompactAt(deq, index)) : ListElementAt(deq, index)->data;
+}
+
+/* Binary search for the first element whose value doesn't come before (upper == 0) or comes after (upper != 0) the value, in a deque that
+   is sorted by the comparison function. Returns the number of elements if there is no such element. */
+static ud_size_t SortedBound(const ud_t deq, const void *const p_data, ud_cmp_t cmp_callback_func, const int upper)
+{
+  ud_size_t lo = 0u, hi = deq->size;
+  while (lo < hi)
+  {
+    ud_size_t mid = lo + (hi - lo) / 2u;
+    int cmp = cmp_callback_func(DataAt(deq, mid), p_data);
+    (upper != 0 ? cmp < 1 : cmp < 0) ? (lo = mid + 1u) : (hi = mid);
+  }
+
+  return lo;
+}
+
+/* Sizes the Bloom filter for twice the number of elements and adds their values. The filter is not used if its words can't be allocated. */
+static void FilterRebuild(const ud_t deq)
+{
+  struct ud_filter *filter = deq->filter;
+  ud_size_t capacity = deq->size > UD_FILTER_MIN_VALUES / 2u ? deq->size * 2u : UD_FILTER_MIN_VALUES;
+  ud_size_t word_count = 1u;
+  while (word_count * (64u / UD_FILTER_BITS_PER_VALUE) < capacity && word_count <= SIZE_MAX / sizeof(uint64_t) / 2u)
+    word_count <<= 1u;
+
+  if (word_count != filter->word_count)
+  {
+    Free(deq, filter->words);
+    Account(deq, 0, -(ud_ssize_t)(filter->word_count * sizeof(uint64_t)), 0);
+    filter->words = (uint64_t *)Alloc(deq, (size_t)word_count * sizeof(uint64_t));
+    filter->word_count = filter->words != NULL ? word_count : 0u;
+    Account(deq, 0, (ud_ssize_t)(filter->word_count * sizeof(uint64_t)), 0);
+  }
+
+  filter->capacity = filter->word_count != 0u ? capacity : 0u;
+  filter->added = 0u;
+  if (filter->word_count == 0u)
+    return;
+
+  memset(filter->words, 0, (size_t)filter->word_count * sizeof(uint64_t));
+  if (IsIndexed(deq))
+  {
+    for (ud_size_t i = 0u; i < deq->size; ++i)
+      FilterAdd(deq, IndexedData(deq, i));
+  }
+  else if (deq->storage == UD_STORAGE_COMPACT)
+  {
+    for (uint32_t node = deq->compact.head; node != UD_NIL_NODE; node = CompactLinks(deq, node)[UD_LINK_NEXT])
+      FilterAdd(deq, CompactNode(deq, node));
+  }
+  else
+  {
+    for (ud_element_t element = deq->head; element != NULL; element = element->next)
+      FilterAdd(deq, element->data);
+  }
+}
+
+/* Returns zero if the Bloom filter proves that no element contains the value. */
+static int FilterMayContain(const ud_t deq, const void *const p_data, ud_cmp_t cmp_callback_func)
+{
+  struct ud_filter *filter = deq->filter;
+  if (filter == NULL || (filter->cmp_func != NULL && filter->cmp_func != cmp_callback_func))
+    return 1;
+
+  // more than half of the values added have been removed if the removed values outnumber the elements
+  if (filter->word_count == 0u || filter->added > filter->capacity || filter->added - deq->size > deq->size)
+    FilterRebuild(deq);
+
+  return filter->word_count == 0u || FilterBits(filter, filter->hash_func(p_data), 0) != 0;
+}
+
+/* Releases the Bloom filter of the deque. */
+static void FilterRelease(const ud_t deq)
+{
+  if (deq->filter != NULL)
+  {
+    Account(deq, 0, -(ud_ssize_t)(deq->filter->word_count * sizeof(uint64_t) + sizeof(struct ud_filter)), 0);
+    Free(deq, deq->filter->words);
+    Free(deq, deq->filter);
+    deq->filter = NULL;
+  }
+}
+
+
+/* Allocates and initializes the object that controls a new deque. */
+static ud_t NewDeque(const ud_allocator_t *allocator)
+{
+  if (allocator == NULL)
+    allocator = &default_allocator;
+  else if (allocator->alloc_func == NULL || allocator->realloc_func == NULL || allocator->free_func == NULL)
+    return NULL;
+
+  ud_t deq = (ud_t)allocator->alloc_func(allocator->context, sizeof(struct ud_detail));
+  if (deq != NULL)
+  {
+    memset(deq, 0, sizeof(struct ud_detail));
+    deq->allocator = *allocator;
+    Account(deq, 0, (ud_ssize_t)sizeof(struct ud_detail), 0);
+  }
+
+  return deq;
+}
+
+
+ud_t UDOpen()
+{
+  return NewDeque(NULL);
+}
+
+ud_t UDOpenWithAllocator(const ud_allocator_t *allocator)
+{
+  return allocator == NULL ? NULL : NewDeque(allocator);
+}
+
+ud_t UDOpenPooled(const ud_size_t max_free)
+{
+  ud_t deq = NewDeque(NULL);
+  if (deq != NULL)
+  {
+    deq->pool.enabled = 1;
+    deq->pool.max_free = max_free;
+  }
+
+  return deq;
+}
+
+ud_t UDOpenArena(const size_t chunk_size)
+{
+  ud_t deq = NewDeque(NULL);
+  if (deq != NULL)
+    deq->arena.chunk_size = chunk_size != 0u ? chunk_size : UD_ARENA_CHUNK_SIZE;
+
+  return deq;
+}
+
+ud_t UDOpenBlocks()
+{
+  ud_t deq = NewDeque(NULL);
+  if (deq != NULL)
+    deq->storage = UD_STORAGE_BLOCKS;
+
+  return deq;
+}
+
+ud_t UDOpenIndexedList()
+{
+  ud_t deq = NewDeque(NULL);
+  if (deq != NULL)
+  {
+    if ((deq->skip = (struct ud_skip_index *)Alloc(deq, sizeof(struct ud_skip_index))) == NULL)
+    {
+      UDClose(deq);
+      return NULL;
+    }
+
+    memset(deq->skip, 0, sizeof(struct ud_skip_index));
+    deq->skip->random = 2463534242u;
+    Account(deq, 0, (ud_ssize_t)sizeof(struct ud_skip_index), 0);
+  }
+
+  return deq;
+}
+
+ud_t UDOpenHashed(ud_hash_t hash_func, ud_cmp_t cmp_callback_func)
+{
+  if (hash_func == NULL)
+    return NULL;
+
+  ud_t deq = UDOpenIndexedList();
+  if (deq != NULL)
+  {
+    if ((deq->hash = (struct ud_hash_index *)Alloc(deq, sizeof(struct ud_hash_index))) == NULL)
+    {
+      UDClose(deq);
+      return NULL;
+    }
+
+    deq->hash->buckets = NULL;
+    deq->hash->count = 0u;
+    deq->hash->hash_func = hash_func;
+    deq->hash->cmp_func = cmp_callback_func;
+    Account(deq, 0, (ud_ssize_t)sizeof(struct ud_hash_index), 0);
+    if (HashResize(deq, UD_HASH_MIN_BUCKETS) == 0)
+    {
+      UDClose(deq);
+      return NULL;
+    }
+  }
+
+  return deq;
+}
+
+ud_t UDOpenStrings(const size_t page_size)
+{
+  ud_t deq = UDOpenBlocks();
+  if (deq != NULL)
+    deq->strings.page_size = page_size != 0u ? page_size : UD_STR_PAGE_SIZE;
+
+  return deq;
+}
+
+ud_t UDOpenSized(const size_t elem_size)
+{
+  ud_t deq = elem_size != 0u ? NewDeque(NULL) : NULL;
+  if (deq != NULL)
+  {
+    deq->storage = UD_STORAGE_RING;
+    deq->elem_size = elem_size;
+    if ((deq->spare = Alloc(deq, elem_size)) == NULL)
+    {
+      UDClose(deq);
+      return NULL;
+    }
+
+    Account(deq, 0, (ud_ssize_t)elem_size, 0);
+  }
+
+  return deq;
+}
+
+ud_t UDOpenBounded(const ud_size_t capacity, const size_t elem_size, const ud_overflow_t policy)
+{
+  ud_t deq = capacity != 0u && elem_size != 0u && capacity <= SIZE_MAX / elem_size ? UDOpenSized(elem_size) : NULL;
+  if (deq != NULL)
+  {
+    deq->ring.bounded = 1;
+    deq->ring.policy = policy;
+    if ((deq->ring.buffer = (unsigned char *)Alloc(deq, (size_t)capacity * elem_size)) == NULL)
+    {
+      UDClose(deq);
+      return NULL;
+    }
+
+    deq->ring.capacity = capacity;
+    Account(deq, 0, 0, (ud_ssize_t)(capacity * elem_size));
+  }
+
+  return deq;
+}
+
+ud_t UDOpenCompact(const size_t elem_size)
+{
+  ud_t deq = elem_size != 0u && elem_size <= UINT32_MAX / 2u ? UDOpenSized(elem_size) : NULL;
+  if (deq != NULL)
+  {
+    // the two links follow the value, and the node size keeps the values aligned as far as the value size allows
+    size_t align = elem_size & (~elem_size + 1u);
+    align = align < sizeof(uint32_t) ? sizeof(uint32_t) : align > sizeof(union ud_align) ? sizeof(union ud_align) : align;
+    deq->storage = UD_STORAGE_COMPACT;
+    deq->compact.head = deq->compact.tail = deq->compact.free_list = UD_NIL_NODE;
+    deq->compact.links_offset = (elem_size + sizeof(uint32_t) - 1u) / sizeof(uint32_t) * sizeof(uint32_t);
+    deq->compact.node_size = (deq->compact.links_offset + 2u * sizeof(uint32_t) + align - 1u) / align * align;
+  }
+
+  return deq;
+}
+
+void *UDPushFront(const ud_t deq, const void *const p_data, const size_t data_size)
+{
+  deq->sorted_cmp = NULL; // the value may not fit into the order
+  if (IsIndexed(deq))
+    return IndexedInsert(deq, 0u, p_data, data_size);
+
+  if (deq->storage == UD_STORAGE_COMPACT)
+    return CompactInsert(deq, deq->compact.head, 0u, p_data, data_size);
+
+  ud_element_t new_element = NewElement(deq, p_data, data_size);
+  if (new_element == NULL)
+    return NULL;
+
+  deq->head != NULL ? (deq->head->previous = new_element) : (deq->tail = new_element);
+  new_element->next = deq->head;
+  new_element->previous = NULL;
+  deq->head = new_element;
+  if (deq->skip != NULL)
+    SkipInsert(deq, new_element, 0u);
+
+  if (deq->hash != NULL)
+    HashAdd(deq, new_element);
+
+  FingerInsert(deq, 0u);
+  ++deq->size;
+  deq->err = 0;
+  return new_element->data;
+}
+
+void *UDFront(const ud_t deq)
+{
+  if (deq->size == 0u)
+  {
+    deq->err = 1;
+    return NULL;
+  }
+
+  deq->err = 0;
+  if (deq->storage == UD_STORAGE_COMPACT)
+    return CompactNode(deq, deq->compact.head);
+
+  return IsIndexed(deq) ? IndexedData(deq, 0u) : deq->head->data;
+}
+
+void *UDPopFront(const ud_t deq)
+{
+  if (deq->size == 0u)
+  {
+    deq->err = 1;
+    return NULL;
+  }
+
+  if (IsIndexed(deq))
+    return IndexedErase(deq, 0u);
+
+  if (deq->storage == UD_STORAGE_COMPACT)
+    return CompactErase(deq, deq->compact.head, 0u);
+
+  void *data = deq->head->data;
+  UnlinkElement(deq, deq->head, 0u);
+  deq->err = 0;
+  return data;
+}
+
+void *UDPushBack(const ud_t deq, const void *const p_data, const size_t data_size)
+{
+  deq->sorted_cmp = NULL; // the value may not fit into the order
+  if (IsIndexed(deq))
+    return IndexedInsert(deq, deq->size, p_data, data_size);
+
+  if (deq->storage == UD_STORAGE_COMPACT)
+    return CompactInsert(deq, UD_NIL_NODE, deq->size, p_data, data_size);
+
+  ud_element_t new_element = NewElement(deq, p_data, data_size);
+  if (new_element == NULL)
+    return NULL;
+
+  deq->tail != NULL ? (deq->tail->next = new_element) : (deq->head = new_element);
+  new_element->previous = deq->tail;
+  new_element->next = NULL;
+  deq->tail = new_element;
+  if (deq->skip != NULL)
+    SkipInsert(deq, new_element, deq->size);
+
+  if (deq->hash != NULL)
+    HashAdd(deq, new_element);
+
+  ++deq->size;
+  deq->err = 0;
+  return new_element->data;
+}
+
+void *UDBack(const ud_t deq)
+{
+  if (deq->size == 0u)
+  {
+    deq->err = 1;
+    return NULL;
+  }
+
+  deq->err = 0;
+  if (deq->storage == UD_STORAGE_COMPACT)
+    return CompactNode(deq, deq->compact.tail);
+
+  return IsIndexed(deq) ? IndexedData(deq, deq->size - 1u) : deq->tail->data;
+}
+
+void *UDPopBack(const ud_t deq)
+{
+  if (deq->size == 0u)
+  {
+    deq->err = 1;
+    return NULL;
+  }
+
+  if (IsIndexed(deq))
+    return IndexedErase(deq, deq->size - 1u);
+
+  if (deq->storage == UD_STORAGE_COMPACT)
+    return CompactErase(deq, deq->compact.tail, deq->size - 1u);
+
+  void *data = deq->tail->data;
+  UnlinkElement(deq, deq->tail, deq->size - 1u);
+  deq->err = 0;
+  return data;
+}
+
+void *UDInsert(const ud_t deq, const ud_size_t index, const void *const p_data, const size_t data_size)
+{
+  if (index >= deq->size)
+  {
+    deq->err = 1;
+    return NULL;
+  }
+
+  deq->sorted_cmp = NULL;
+
+  if (IsIndexed(deq))
+    return IndexedInsert(deq, index, p_data, data_size);
+
+  if (deq->storage == UD_STORAGE_COMPACT)
+    return CompactInsert(deq, CompactAt(deq, index), index, p_data, data_size);
+
+  ud_element_t new_element = NewElement(deq, p_data, data_size);
+  if (new_element == NULL)
+    return NULL;
+
+  ud_element_t current_element = ListElementAt(deq, index);
+  current_element->previous == NULL ? (deq->head = new_element) : (current_element->previous->next = new_element);
+  new_element->previous = current_element->previous;
+  new_element->next = current_element;
+  current_element->previous = new_element;
+  if (deq->skip != NULL)
+    SkipInsert(deq, new_element, index);
+
+  if (deq->hash != NULL)
+    HashAdd(deq, new_element);
+
+  FingerInsert(deq, index);
+  ++deq->size;
+  deq->err = 0;
+  return new_element->data;
+}
+
+void *UDAt(const ud_t deq, const ud_size_t index)
+{
+  if (index >= deq->size)
+  {
+    deq->err = 1;
+    return NULL;
+  }
+
+  if (IsIndexed(deq))
+  {
+    deq->err = 0;
+    return IndexedData(deq, index);
+  }
+
+  if (deq->storage == UD_STORAGE_COMPACT)
+  {
+    deq->err = 0;
+    return CompactNode(deq, CompactAt(deq, index));
+  }
+
+  deq->err = 0;
+  return ListElementAt(deq, index)->data;
+}
+
+void *UDErase(const ud_t deq, const ud_size_t index)
+{
+  if (index >= deq->size)
+  {
+    deq->err = 1;
+    return NULL;
+  }
+
+  if (IsIndexed(deq))
+    return IndexedErase(deq, index);
+
+  if (deq->storage == UD_STORAGE_COMPACT)
+    return CompactErase(deq, CompactAt(deq, index), index);
+
+  ud_element_t current_element = ListElementAt(deq, index);
+  UnlinkElement(deq, current_element, index);
+  deq->err = 0;
+  return current_element->data;
+}
+
+int UDForEach(const ud_t deq, const ud_size_t start_idx, const ud_ssize_t number, ud_for_each_proc_t callback_func, void *user_parameter)
+{
+  if (number == 0 || start_idx >= deq->size || start_idx + number + (number < 0 ? 1 : -1) >= deq->size)
+  {
+    deq->err = 1;
+    return 0;
+  }
+
+  if (IsIndexed(deq))
+  {
+    for (ud_size_t i = number < 0 ? -number : number, index = start_idx; i-- > 0 && callback_func(IndexedData(deq, index), user_parameter) != 0; number < 0 ? --index : ++index);
+
+    deq->err = 0;
+    return 1;
+  }
+
+  if (deq->storage == UD_STORAGE_COMPACT)
+  {
+    for (ud_size_t i = number < 0 ? -number : number, node = CompactAt(deq, start_idx); i-- > 0 && callback_func(CompactNode(deq, (uint32_t)node), user_parameter) != 0; node = CompactLinks(deq, (uint32_t)node)[number < 0 ? UD_LINK_PREVIOUS : UD_LINK_NEXT]);
+
+    deq->err = 0;
+    return 1;
+  }
+
+  ud_element_t current_element = ListElementAt(deq, start_idx);
+  for (ud_size_t i = number < 0 ? -number : number; i-- > 0; )
+  {
+    if (current_element == NULL)
+    {
+      deq->err = 1;
+      return 0;
+    }
+
+    if (callback_func(current_element->data, user_parameter) == 0)
+      break;
+
+    current_element = number < 0 ? current_element->previous : current_element->next;
+  }
+
+  deq->err = 0;
+  return 1;
+}
+
+int UDCursorBegin(const ud_t deq, ud_cursor_t *p_cursor)
+{
+  p_cursor->element = deq->head;
+  p_cursor->node = deq->compact.head;
+  p_cursor->index = 0u;
+  deq->err = 0;
+  return deq->size != 0u;
+}
+
+int UDCursorEnd(const ud_t deq, ud_cursor_t *p_cursor)
+{
+  p_cursor->element = NULL;
+  p_cursor->node = UD_NIL_NODE;
+  p_cursor->index = deq->size;
+  deq->err = 0;
+  return deq->size != 0u;
+}
+
+int UDCursorNext(const ud_t deq, ud_cursor_t *p_cursor)
+{
+  if (p_cursor->index >= deq->size)
+  {
+    deq->err = 1;
+    return 0;
+  }
+
+  if (deq->storage == UD_STORAGE_COMPACT)
+    p_cursor->node = CompactLinks(deq, p_cursor->node)[UD_LINK_NEXT];
+  else if (deq->storage == UD_STORAGE_LIST)
+    p_cursor->element = p_cursor->element->next;
+
+  deq->err = 0;
+  return ++p_cursor->index != deq->size;
+}
+
+int UDCursorPrev(const ud_t deq, ud_cursor_t *p_cursor)
+{
+  if (p_cursor->index == 0u || p_cursor->index > deq->size)
+  {
+    deq->err = 1;
+    return 0;
+  }
+
+  if (deq->storage == UD_STORAGE_COMPACT)
+    p_cursor->node = p_cursor->node != UD_NIL_NODE ? CompactLinks(deq, p_cursor->node)[UD_LINK_PREVIOUS] : deq->compact.tail;
+  else if (deq->storage == UD_STORAGE_LIST)
+    p_cursor->element = p_cursor->element != NULL ? p_cursor->element->previous : deq->tail;
+
+  --p_cursor->index;
+  deq->err = 0;
+  return 1;
+}
+
+void *UDCursorGet(const ud_t deq, const ud_cursor_t *p_cursor)
+{
+  if (p_cursor->index >= deq->size)
+  {
+    deq->err = 1;
+    return NULL;
+  }
+
+  deq->err = 0;
+  if (IsIndexed(deq))
+    return IndexedData(deq, p_cursor->index);
+
+  return deq->storage == UD_STORAGE_COMPACT ? CompactNode(deq, p_cursor->node) : p_cursor->element->data;
+}
+
+void *UDCursorInsertBefore(const ud_t deq, ud_cursor_t *p_cursor, const void *const p_data, const size_t data_size)
+{
+  if (p_cursor->index > deq->size)
+  {
+    deq->err = 1;
+    return NULL;
+  }
+
+  deq->sorted_cmp = NULL;
+
+  if (IsIndexed(deq))
+  {
+    // a bounded deque that overwrites the oldest element may remove the first element rather than growing
+    ud_size_t old_size = deq->size;
+    void *data = IndexedInsert(deq, p_cursor->index, p_data, data_size);
+    if (data != NULL && (deq->size != old_size || p_cursor->index == 0u))
+      ++p_cursor->index;
+
+    return data;
+  }
+
+  if (deq->storage == UD_STORAGE_COMPACT)
+  {
+    void *data = CompactInsert(deq, p_cursor->node, p_cursor->index, p_data, data_size);
+    if (data != NULL)
+      ++p_cursor->index;
+
+    return data;
+  }
+
+  ud_element_t new_element = NewElement(deq, p_data, data_size);
+  if (new_element == NULL)
+    return NULL;
+
+  ud_element_t next_element = p_cursor->element;
+  new_element->previous = next_element != NULL ? next_element->previous : deq->tail;
+  new_element->next = next_element;
+  new_element->previous != NULL ? (new_element->previous->next = new_element) : (deq->head = new_element);
+  next_element != NULL ? (next_element->previous = new_element) : (deq->tail = new_element);
+  if (deq->skip != NULL)
+    SkipInsert(deq, new_element, p_cursor->index);
+
+  if (deq->hash != NULL)
+    HashAdd(deq, new_element);
+
+  FingerInsert(deq, p_cursor->index);
+  ++deq->size;
+  ++p_cursor->index;
+  deq->err = 0;
+  return new_element->data;
+}
+
+void *UDCursorErase(const ud_t deq, ud_cursor_t *p_cursor)
+{
+  if (p_cursor->index >= deq->size)
+  {
+    deq->err = 1;
+    return NULL;
+  }
+
+  if (IsIndexed(deq))
+    return IndexedErase(deq, p_cursor->index);
+
+  if (deq->storage == UD_STORAGE_COMPACT)
+  {
+    uint32_t node = p_cursor->node;
+    p_cursor->node = CompactLinks(deq, node)[UD_LINK_NEXT];
+    return CompactErase(deq, node, p_cursor->index);
+  }
+
+  ud_element_t current_element = p_cursor->element;
+  UnlinkElement(deq, current_element, p_cursor->index);
+  p_cursor->element = current_element->next;
+  deq->err = 0;
+  return current_element->data;
+}
+
+/* Sorts the deque using the natural merge sort of the data pointers that sort_items refers to, the generic SortItems() or a version that is
+   specialized for the type. Small linked lists are sorted by relinking the elements using the comparison function. */
+static int SortDeque(const ud_t deq, ud_cmp_t cmp_callback_func, void (*sort_items)(void **, const ud_size_t, void **, ud_cmp_t))
+{
+  if (deq->size == 0u)
+  {
+    deq->err = 1;
+    return 0;
+  }
+
+  if (deq->storage != UD_STORAGE_LIST || deq->size >= UD_SORT_GATHER_MIN_SIZE)
+  {
+    // gather the data pointers in a contiguous array, sort it, and write it back (or relink the elements in one pass)
+    void **items = (void **)Alloc(deq, deq->size * sizeof(void *));
+    unsigned char *new_buffer = NULL;
+    int ret = items != NULL && (deq->storage != UD_STORAGE_RING || (new_buffer = (unsigned char *)Alloc(deq, deq->ring.capacity * deq->elem_size)) != NULL);
+    if (ret != 0)
+    {
+      GatherData(deq, items);
+      ret = SortDataArray(deq, items, deq->size, cmp_callback_func, sort_items);
+      ret != 0 ? ApplyOrder(deq, items, new_buffer) : Free(deq, new_buffer);
+    }
+
+    Free(deq, items);
+    if (ret != 0 || deq->storage != UD_STORAGE_LIST)
+    {
+      if (ret != 0)
+        deq->sorted_cmp = cmp_callback_func;
+
+      deq->err = !ret;
+      return ret;
+    }
+
+    // a list is sorted by relinking the elements if the array can't be allocated
+  }
+
+  // natural merge sort, the runs of the list are detected and merged like the runs of an array
+  struct ud_run runs[UD_SORT_MAX_RUNS];
+  ud_size_t run_length[UD_SORT_MAX_RUNS];
+  int run_count = 0;
+  for (ud_element_t element = deq->head, next = NULL; element != NULL; )
+  {
+    struct ud_run *run = runs + run_count;
+    run->head = run->tail = element;
+    run_length[run_count] = 1u;
+    element = element->next;
+    if (element != NULL && cmp_callback_func(element->data, run->head->data) < 0)
+    {
+      // a strictly descending run is reversed by prepending each element
+      do
+      {
+        next = element->next;
+        element->next = run->head;
+        run->head = element;
+        ++run_length[run_count];
+        element = next;
+      } while (element != NULL && cmp_callback_func(element->data, run->head->data) < 0);
+    }
+    else if (element != NULL)
+    {
+      do
+      {
+        run->tail = element;
+        ++run_length[run_count];
+        element = element->next;
+      } while (element != NULL && cmp_callback_func(element->data, run->tail->data) > -1);
+    }
+
+    run->tail->next = NULL;
+    ++run_count;
+    for (int k = NextMerge(run_length, run_count, element == NULL); k >= 0; k = NextMerge(run_length, run_count, element == NULL))
+    {
+      MergeListRuns(runs + k, runs + k + 1, cmp_callback_func);
+      run_length[k] += run_length[k + 1];
+      for (int i = k + 1; i < run_count - 1; ++i)
+      {
+        runs[i] = runs[i + 1];
+        run_length[i] = run_length[i + 1];
+      }
+
+      --run_count;
+    }
+  }
+
+  // the previous links are restored in one pass
+  ud_element_t front = runs[0].head, back = NULL;
+  for (ud_element_t element = front; element != NULL; back = element, element = element->next)
+    element->previous = back;
+
+  deq->head = front;
+  deq->tail = back;
+  deq->finger.valid = 0;
+  deq->sorted_cmp = cmp_callback_func;
+  if (deq->skip != NULL)
+    SkipRebuild(deq);
+
+  deq->err = 0;
+  return 1;
+}
+
+int UDSort(const ud_t deq, ud_cmp_t cmp_callback_func)
+{
+  return SortDeque(deq, cmp_callback_func, SortItems);
+}
+
+/* Procedures of the tasks of UDSortParallel(). */
+static void SortTask(struct ud_sort_task *task)
+{
+  task->sort_items(task->src + task->first_begin, task->first_end - task->first_begin, task->dest + task->first_begin, task->cmp_func);
+}
+
+static void MergeTask(struct ud_sort_task *task)
+{
+  task->merge_items(task->src + task->first_begin, task->first_end - task->first_begin, task->src + task->second_begin, task->second_end - task->second_begin,
+                    task->dest + task->dest_begin, task->cmp_func);
+}
+
+/* Thread procedure that does the task passed. */
+#if defined(UD_USE_PTHREADS)
+static void *TaskThread(void *p_task)
+{
+  struct ud_sort_task *task = (struct ud_sort_task *)p_task;
+  task->run(task);
+  return NULL;
+}
+#elif defined(UD_USE_WIN32_THREADS)
+static unsigned __stdcall TaskThread(void *p_task)
+{
+  struct ud_sort_task *task = (struct ud_sort_task *)p_task;
+  task->run(task);
+  return 0u;
+}
+#endif
+
+/* Runs each task in a thread of its own. The last task, and tasks whose threads can't be created, are run in the calling thread. */
+static void RunTasks(struct ud_sort_task *tasks, const ud_size_t count, void (*task_proc)(struct ud_sort_task *))
+{
+#if defined(UD_USE_PTHREADS)
+  pthread_t threads[UD_SORT_MAX_THREADS];
+  int started[UD_SORT_MAX_THREADS];
+  for (ud_size_t i = 0u; i + 1u < count; ++i)
+  {
+    tasks[i].run = task_proc;
+    started[i] = pthread_create(threads + i, NULL, TaskThread, tasks + i) == 0;
+    if (started[i] == 0)
+      task_proc(tasks + i);
+  }
+
+  task_proc(tasks + count - 1u);
+  for (ud_size_t i = 0u; i + 1u < count; ++i)
+  {
+    if (started[i] != 0)
+      pthread_join(threads[i], NULL);
+  }
+#elif defined(UD_USE_WIN32_THREADS)
+  // at most UD_SORT_MAX_THREADS - 1 threads are started, which doesn't exceed MAXIMUM_WAIT_OBJECTS
+  HANDLE threads[UD_SORT_MAX_THREADS];
+  DWORD started = 0u;
+  for (ud_size_t i = 0u; i + 1u < count; ++i)
+  {
+    tasks[i].run = task_proc;
+    uintptr_t thread = _beginthreadex(NULL, 0u, TaskThread, tasks + i, 0u, NULL);
+    if (thread != 0u)
+      threads[started++] = (HANDLE)thread;
+    else
+      task_proc(tasks + i);
+  }
+
+  task_proc(tasks + count - 1u);
+  if (started != 0u)
+    WaitForMultipleObjects(started, threads, TRUE, INFINITE);
+
+  for (DWORD i = 0u; i < started; ++i)
+    CloseHandle(threads[i]);
+#else
+  for (ud_size_t i = 0u; i < count; ++i)
+    task_proc(tasks + i);
+#endif
+}
+
+/* Returns the number of items of the first run among the first k items of the merged runs, the items of the first run come first if the
+   values are equal. This splits a merge into independent merges of consecutive parts. */
+static ud_size_t MergeSplit(void **first, const ud_size_t first_count, void **second, const ud_size_t second_count, const ud_size_t k, ud_cmp_t cmp_callback_func)
+{
+  ud_size_t lo = k > second_count ? k - second_count : 0u, hi = k < first_count ? k : first_count;
+  while (lo < hi)
+  {
+    ud_size_t mid = lo + (hi - lo) / 2u;
+    cmp_callback_func(first[mid], second[k - mid - 1u]) < 1 ? (lo = mid + 1u) : (hi = mid);
+  }
+
+  return lo;
+}
+
+/* Sorts the deque like SortDeque() using multiple threads. */
+static int SortParallel(const ud_t deq, ud_cmp_t cmp_callback_func, const ud_size_t thread_count, void (*sort_items)(void **, const ud_size_t, void **, ud_cmp_t),
+                        void (*merge_items)(void **, const ud_size_t, void **, const ud_size_t, void **, ud_cmp_t))
+{
+  ud_size_t threads = thread_count < UD_SORT_MAX_THREADS ? thread_count : UD_SORT_MAX_THREADS, count = deq->size;
+  if (threads > count / UD_SORT_PARALLEL_MIN_SIZE)
+    threads = count / UD_SORT_PARALLEL_MIN_SIZE;
+
+  void **items = threads > 1u && count <= SIZE_MAX / 2u / sizeof(void *) ? (void **)Alloc(deq, (size_t)count * 2u * sizeof(void *)) : NULL;
+  unsigned char *new_buffer = NULL;
+  if (items == NULL || (deq->storage == UD_STORAGE_RING && (new_buffer = (unsigned char *)Alloc(deq, deq->ring.capacity * deq->elem_size)) == NULL))
+  {
+    Free(deq, items);
+    return SortDeque(deq, cmp_callback_func, sort_items);
+  }
+
+  // the segments are sorted in parallel, then pairs of adjacent segments are merged into the other half of the array until one segment is
+  // left, each merge is split into as many parts as there are threads for the pair
+  struct ud_sort_task tasks[UD_SORT_MAX_THREADS];
+  ud_size_t segment_begin[UD_SORT_MAX_THREADS + 1u];
+  void **src = items, **dest = items + count;
+  GatherData(deq, items);
+  for (ud_size_t i = 0u; i <= threads; ++i)
+    segment_begin[i] = count / threads * i + (i < count % threads ? i : count % threads);
+
+  for (ud_size_t i = 0u; i < threads; ++i)
+  {
+    struct ud_sort_task task = { src, dest, segment_begin[i], segment_begin[i + 1u], 0u, 0u, 0u, cmp_callback_func, sort_items, merge_items, NULL };
+    tasks[i] = task;
+  }
+
+  RunTasks(tasks, threads, SortTask);
+  for (ud_size_t segments = threads; segments > 1u; segments = (segments + 1u) / 2u)
+  {
+    ud_size_t pairs = (segments + 1u) / 2u, share = threads / pairs, task_count = 0u;
+    for (ud_size_t p = 0u; p < pairs; ++p)
+    {
+      ud_size_t first = segment_begin[2u * p], second = segment_begin[2u * p + 1u], end = 2u * p + 2u <= segments ? segment_begin[2u * p + 2u] : second;
+      for (ud_size_t t = 0u, k = 0u, i = 0u; t < share; ++t)
+      {
+        ud_size_t next_k = t + 1u < share ? (end - first) / share * (t + 1u) : end - first;
+        ud_size_t next_i = MergeSplit(src + first, second - first, src + second, end - second, next_k, cmp_callback_func);
+        struct ud_sort_task task = { src, dest, first + i, first + next_i, second + (k - i), second + (next_k - next_i), first + k, cmp_callback_func, sort_items, merge_items, NULL };
+        tasks[task_count++] = task;
+        k = next_k;
+        i = next_i;
+      }
+
+      segment_begin[p] = first;
+    }
+
+    RunTasks(tasks, task_count, MergeTask);
+    segment_begin[pairs] = count;
+    void **tmp = src;
+    src = dest;
+    dest = tmp;
+  }
+
+  ApplyOrder(deq, src, new_buffer);
+  Free(deq, items);
+  deq->sorted_cmp = cmp_callback_func;
+  deq->err = 0;
+  return 1;
+}
+
+int UDSortParallel(const ud_t deq, ud_cmp_t cmp_callback_func, const ud_size_t thread_count)
+{
+  return SortParallel(deq, cmp_callback_func, thread_count, SortItems, MergeItems);
+}
+
+/* Inserts the value behind the last element whose value doesn't come after it. Thus, values that compare equal keep the order in which they
+   were inserted. The elements that the binary search compares are reached through the finger in a linked list or compact deque. */
+static void *InsertSortedValue(const ud_t deq, const void *const p_data, const size_t data_size, ud_cmp_t cmp_callback_func)
+{
+  if (deq->size == 0u || cmp_callback_func(p_data, UDFront(deq)) < 0)
+    return UDPushFront(deq, p_data, data_size);
+
+  if (cmp_callback_func(p_data, UDBack(deq)) > -1)
+    return UDPushBack(deq, p_data, data_size);
+
+  return UDInsert(deq, SortedBound(deq, p_data, cmp_callback_func, 1), p_data, data_size);
+}
+
+void *UDInsertSorted(const ud_t deq, const void *const p_data, const size_t data_size, ud_cmp_t cmp_callback_func)
+{
+  // the deque is known to be sorted by the comparison function afterwards if it was empty or already known to be sorted by it
+  ud_cmp_t sorted_cmp = deq->sorted_cmp;
+  int keeps_order = deq->size == 0u || sorted_cmp == cmp_callback_func;
+  void *data = InsertSortedValue(deq, p_data, data_size, cmp_callback_func);
+  deq->sorted_cmp = deq->err != 0 ? sorted_cmp : (keeps_order != 0 ? cmp_callback_func : NULL);
+  return data;
+}
+
+ud_size_t UDLowerBound(const ud_t deq, const void *const p_data, ud_cmp_t cmp_callback_func)
+{
+  deq->err = 0;
+  return SortedBound(deq, p_data, cmp_callback_func, 0);
+}
+
+ud_size_t UDUpperBound(const ud_t deq, const void *const p_data, ud_cmp_t cmp_callback_func)
+{
+  deq->err = 0;
+  return SortedBound(deq, p_data, cmp_callback_func, 1);
+}
+
+ud_size_t UDFind(const ud_t deq, const void *const p_data, ud_cmp_t cmp_callback_func)
+{
+  if (FilterMayContain(deq, p_data, cmp_callback_func) == 0)
+  {
+    deq->err = 1;
+    return UD_INVALID_IDX;
+  }
+
+  if (deq->sorted_cmp == cmp_callback_func && deq->hash == NULL)
+  {
+    ud_size_t index = SortedBound(deq, p_data, cmp_callback_func, 0);
+    deq->err = index == deq->size || cmp_callback_func(p_data, DataAt(deq, index)) != 0;
+    return deq->err == 0 ? index : UD_INVALID_IDX;
+  }
+
+  if (IsIndexed(deq))
+  {
+    for (ud_size_t index = 0u; index < deq->size; ++index)
+    {
+      if (cmp_callback_func(p_data, IndexedData(deq, index)) == 0)
+      {
+        deq->err = 0;
+        return index;
+      }
+    }
+
+    deq->err = 1;
+    return UD_INVALID_IDX;
+  }
+
+  if (deq->storage == UD_STORAGE_COMPACT)
+  {
+    ud_size_t index = 0u;
+    for (uint32_t node = deq->compact.head; node != UD_NIL_NODE; node = CompactLinks(deq, node)[UD_LINK_NEXT], ++index)
+    {
+      if (cmp_callback_func(p_data, CompactNode(deq, node)) == 0)
+      {
+        deq->err = 0;
+        return index;
+      }
+    }
+
+    deq->err = 1;
+    return UD_INVALID_IDX;
+  }
+
+  ud_size_t index = 0u;
+  if (deq->hash != NULL)
+  {
+    deq->err = HashFind(deq, p_data, cmp_callback_func, &index) == NULL;
+    return deq->err == 0 ? index : UD_INVALID_IDX;
+  }
+
+  for (ud_element_t current_element = deq->head; current_element != NULL; current_element = current_element->next, ++index)
+  {
+    if (cmp_callback_func(p_data, current_element->data) == 0)
+    {
+      deq->err = 0;
+      return index;
+    }
+  }
+
+  deq->err = 1;
+  return UD_INVALID_IDX;
 }
 
-void *UDPopFront(const ud_t deq)
+void *UDRemove(const ud_t deq, const void *const p_data, ud_cmp_t cmp_callback_func)
 {
-  if (deq->head == NULL)
+  if (IsIndexed(deq) || (deq->sorted_cmp == cmp_callback_func && deq->hash == NULL))
+  {
+    ud_size_t index = UDFind(deq, p_data, cmp_callback_func);
+    return index == UD_INVALID_IDX ? NULL : UDErase(deq, index);
+  }
+
+  if (FilterMayContain(deq, p_data, cmp_callback_func) == 0)
   {
     deq->err = 1;
     return NULL;
   }
 
-  --deq->size;
-  void *data = deq->head->data;
-  ud_element_t new_head = deq->head->next;
-  free(deq->head);
-  deq->head = new_head;
-  new_head != NULL ? (new_head->previous = NULL) : (deq->tail = NULL);
-  deq->err = 0;
-  return data;
-}
-
-void *UDPushBack(const ud_t deq, const void *const p_data, const size_t data_size)
-{
-  ud_element_t new_element = NULL;
-  void *new_data = NULL;
-  if ((new_element = (ud_element_t)malloc(sizeof(struct ud_element))) == NULL || (new_data = malloc(data_size)) == NULL)
+  if (deq->storage == UD_STORAGE_COMPACT)
   {
+    ud_size_t index = 0u;
+    for (uint32_t node = deq->compact.head; node != UD_NIL_NODE; node = CompactLinks(deq, node)[UD_LINK_NEXT], ++index)
+    {
+      if (cmp_callback_func(p_data, CompactNode(deq, node)) == 0)
+        return CompactErase(deq, node, index);
+    }
+
     deq->err = 1;
-    free(new_element);
     return NULL;
   }
 
-  new_element->data = memcpy(new_data, p_data, data_size);
-  deq->tail != NULL ? (deq->tail->next = new_element) : (deq->head = new_element);
-  new_element->previous = deq->tail;
-  new_element->next = NULL;
-  deq->tail = new_element;
-  ++deq->size;
-  deq->err = 0;
-  return new_data;
-}
+  ud_size_t index = 0u;
+  ud_element_t current_element = NULL;
+  if (deq->hash != NULL)
+    current_element = HashFind(deq, p_data, cmp_callback_func, &index);
+  else
+    for (current_element = deq->head; current_element != NULL && cmp_callback_func(p_data, current_element->data) != 0; current_element = current_element->next, ++index);
 
-void *UDBack(const ud_t deq)
-{
-  if (deq->tail == NULL)
+  if (current_element == NULL)
   {
     deq->err = 1;
     return NULL;
   }
 
+  UnlinkElement(deq, current_element, index);
   deq->err = 0;
-  return deq->tail->data;
+  return current_element->data;
 }
 
-void *UDPopBack(const ud_t deq)
+int UDReverse(const ud_t deq)
 {
-  if (deq->tail == NULL)
+  if (deq->size == 0u)
   {
     deq->err = 1;
-    return NULL;
+    return 0;
   }
 
-  --deq->size;
-  void *data = deq->tail->data;
-  ud_element_t new_tail = deq->tail->previous;
-  free(deq->tail);
-  deq->tail = new_tail;
-  new_tail != NULL ? (new_tail->next = NULL) : (deq->head = NULL);
-  deq->err = 0;
-  return data;
-}
+  deq->sorted_cmp = NULL;
 
-void *UDInsert(const ud_t deq, const ud_size_t index, const void *const p_data, const size_t data_size)
-{
-  ud_element_t new_element = NULL;
-  void *new_data = NULL;
-  if (index >= deq->size || (new_element = (ud_element_t)malloc(sizeof(struct ud_element))) == NULL || (new_data = malloc(data_size)) == NULL)
+  if (deq->storage == UD_STORAGE_BLOCKS)
   {
-    deq->err = 1;
-    free(new_element);
-    return NULL;
+    for (ud_size_t lo = 0u, hi = deq->size - 1u; lo < hi; ++lo, --hi)
+    {
+      void *tmp = *BlockSlot(&deq->map, lo);
+      *BlockSlot(&deq->map, lo) = *BlockSlot(&deq->map, hi);
+      *BlockSlot(&deq->map, hi) = tmp;
+    }
+
+    deq->err = 0;
+    return 1;
   }
 
-  new_element->data = memcpy(new_data, p_data, data_size);
-  ud_size_t tail_distance = deq->size - index - 1;
-  ud_element_t current_element = tail_distance < index ? deq->tail : deq->head;
-  for (ud_size_t i = tail_distance < index ? tail_distance : index; i-- > 0; )
-    current_element = tail_distance < index ? current_element->previous : current_element->next;
+  if (deq->storage == UD_STORAGE_RING)
+  {
+    for (ud_size_t lo = 0u, hi = deq->size - 1u; lo < hi; ++lo, --hi)
+    {
+      unsigned char *p_1 = RingSlot(deq, lo), *p_2 = RingSlot(deq, hi);
+      for (size_t i = 0u; i < deq->elem_size; ++i)
+      {
+        unsigned char tmp = p_1[i];
+        p_1[i] = p_2[i];
+        p_2[i] = tmp;
+      }
+    }
 
-  current_element->previous == NULL ? (deq->head = new_element) : (current_element->previous->next = new_element);
-  new_element->previous = current_element->previous;
-  new_element->next = current_element;
-  current_element->previous = new_element;
-  ++deq->size;
-  deq->err = 0;
-  return new_data;
-}
+    deq->err = 0;
+    return 1;
+  }
 
-void *UDAt(const ud_t deq, const ud_size_t index)
-{
-  if (index >= deq->size)
+  if (deq->storage == UD_STORAGE_COMPACT)
   {
-    deq->err = 1;
-    return NULL;
+    for (uint32_t node = deq->compact.head; node != UD_NIL_NODE; )
+    {
+      uint32_t *links = CompactLinks(deq, node);
+      uint32_t next = links[UD_LINK_NEXT];
+      links[UD_LINK_NEXT] = links[UD_LINK_PREVIOUS];
+      links[UD_LINK_PREVIOUS] = next;
+      node = next;
+    }
+
+    uint32_t tmp = deq->compact.head;
+    deq->compact.head = deq->compact.tail;
+    deq->compact.tail = tmp;
+    deq->finger.index = deq->size - 1u - deq->finger.index;
+    deq->err = 0;
+    return 1;
+  }
+
+  ud_element_t tmp = NULL;
+  for (ud_element_t current_element = deq->head; current_element != NULL; current_element = tmp)
+  {
+    tmp = current_element->next;
+    current_element->next = current_element->previous;
+    current_element->previous = tmp;
   }
 
-  ud_size_t tail_distance = deq->size - index - 1;
-  ud_element_t current_element = tail_distance < index ? deq->tail : deq->head;
-  for (ud_size_t i = tail_distance < index ? tail_distance : index; i-- > 0; )
-    current_element = tail_distance < index ? current_element->previous : current_element->next;
+  tmp = deq->head;
+  deq->head = deq->tail;
+  deq->tail = tmp;
+  deq->finger.index = deq->size - 1u - deq->finger.index;
+  if (deq->skip != NULL)
+    SkipRebuild(deq);
 
   deq->err = 0;
-  return current_element->data;
+  return 1;
 }
 
-void *UDErase(const ud_t deq, const ud_size_t index)
+ud_size_t UDSize(const ud_t deq)
 {
-  if (index >= deq->size)
-  {
-    deq->err = 1;
-    return NULL;
-  }
+  deq->err = 0;
+  return deq->size;
+}
 
-  ud_size_t tail_distance = --deq->size - index;
-  ud_element_t current_element = tail_distance < index ? deq->tail : deq->head;
-  for (ud_size_t i = tail_distance < index ? tail_distance : index; i-- > 0; )
-    current_element = tail_distance < index ? current_element->previous : current_element->next;
+int UDEmpty(const ud_t deq)
+{
+  deq->err = 0;
+  return deq->size == 0u;
+}
 
-  void *data = current_element->data;
-  current_element->previous != NULL ? (current_element->previous->next = current_element->next) : (deq->head = current_element->next);
-  current_element->next != NULL ? (current_element->next->previous = current_element->previous) : (deq->tail = current_element->previous);
-  free(current_element);
+int UDFailed(const ud_t deq)
+{
+  int current_err = deq->err;
   deq->err = 0;
-  return data;
+  return current_err;
 }
 
-int UDForEach(const ud_t deq, const ud_size_t start_idx, const ud_ssize_t number, ud_for_each_proc_t callback_func, void *user_parameter)
+void UDDeleteData(const ud_t deq, void *p_data)
 {
-  if (number == 0 || start_idx >= deq->size || start_idx + number + (number < 0 ? 1 : -1) >= deq->size)
+  deq->err = 0;
+  if (p_data != NULL)
   {
-    deq->err = 1;
-    return 0;
+    if (deq->storage == UD_STORAGE_BLOCKS)
+      BlockMapFreeData(deq, p_data);
+    else if (deq->storage == UD_STORAGE_LIST)
+      ReleaseElement(deq, DataElement(p_data));
   }
+}
 
-  ud_size_t tail_distance = deq->size - start_idx - 1;
-  ud_element_t current_element = tail_distance < start_idx ? deq->tail : deq->head;
-  for (ud_size_t i = tail_distance < start_idx ? tail_distance : start_idx; i-- > 0; )
-    current_element = tail_distance < start_idx ? current_element->previous : current_element->next;
+void UDClear(const ud_t deq)
+{
+  if (deq->storage == UD_STORAGE_BLOCKS)
+  {
+    for (ud_size_t i = 0u; i < deq->size; ++i)
+      BlockMapFreeData(deq, *BlockSlot(&deq->map, i));
 
-  for (ud_size_t i = number < 0 ? -number : number; i-- > 0; )
+    Account(deq, 0, -(ud_ssize_t)(deq->size * sizeof(void *)), (ud_ssize_t)(deq->size * sizeof(void *)));
+  }
+  else if (deq->storage == UD_STORAGE_RING)
   {
-    if (current_element == NULL)
+    Account(deq, -(ud_ssize_t)(deq->size * deq->elem_size), 0, (ud_ssize_t)(deq->size * deq->elem_size));
+    deq->ring.first = 0u;
+  }
+  else if (deq->storage == UD_STORAGE_COMPACT)
+  {
+    Account(deq, -(ud_ssize_t)(deq->size * deq->elem_size), -(ud_ssize_t)(deq->size * (deq->compact.node_size - deq->elem_size)), (ud_ssize_t)(deq->size * deq->compact.node_size));
+    deq->compact.head = deq->compact.tail = deq->compact.free_list = UD_NIL_NODE;
+    deq->compact.used = 0u;
+  }
+  else if (deq->arena.chunk_size != 0u)
+    ArenaRelease(deq);
+  else
+  {
+    for (ud_element_t element = deq->head, next = NULL; element != NULL; element = next)
     {
-      deq->err = 1;
-      return 0;
+      next = element->next;
+      ReleaseElement(deq, element);
     }
 
-    if (callback_func(current_element->data, user_parameter) == 0)
-      break;
+    if (deq->skip != NULL)
+      deq->skip->levels = 0u;
 
-    current_element = number < 0 ? current_element->previous : current_element->next;
+    for (ud_size_t i = 0u; deq->hash != NULL && i < deq->hash->count; ++i)
+      deq->hash->buckets[i] = NULL;
   }
 
+  deq->head = deq->tail = NULL;
+  deq->finger.valid = 0;
+  deq->sorted_cmp = NULL;
+  deq->size = 0u;
   deq->err = 0;
-  return 1;
 }
 
-int UDSort(const ud_t deq, ud_cmp_t cmp_callback_func)
+int UDMemoryUsage(const ud_t deq, ud_memory_usage_t *p_usage)
 {
-  if (deq->size == 0u)
+  if (p_usage == NULL)
   {
     deq->err = 1;
     return 0;
   }
 
-  ud_element_t front = deq->head, back = NULL, left = NULL, right = NULL;
-  for (ud_size_t max_extent = 1u, l_extent = 0u, r_extent = 0u, merge_cnt = UINT64_MAX; merge_cnt > 1u; back->next = NULL, max_extent <<= 1u)
-  {
-    for (merge_cnt = 0u, left = right = front, front = back = NULL ;left != NULL; ++merge_cnt, left = right)
-    {
-      for (l_extent = 1u, r_extent = max_extent, right = left->next; l_extent < max_extent && right != NULL; ++l_extent, right = right->next);
-      for (ud_element_t picked = NULL; l_extent != 0u || (r_extent != 0u && right != NULL); back == NULL ? (front = picked) : (back->next = picked), picked->previous = back, back = picked)
-      {
-        if (l_extent != 0u && (r_extent == 0u || right == NULL || cmp_callback_func(left->data, right->data) < 1))
-        {
-          --l_extent;
-          picked = left;
-          left = left->next;
-        }
-        else
-        {
-          --r_extent;
-          picked = right;
-          right = right->next;
-        }
-      }
-    }
-  }
-
-  deq->head = front;
-  deq->tail = back;
+  p_usage->payload_bytes = deq->usage.payload;
+  p_usage->metadata_bytes = deq->usage.metadata;
+  p_usage->free_bytes = deq->usage.free_bytes;
+  p_usage->peak_bytes = deq->usage.peak;
   deq->err = 0;
   return 1;
 }
 
-void *UDInsertSorted(const ud_t deq, const void *const p_data, const size_t data_size, ud_cmp_t cmp_callback_func)
+int UDReserve(const ud_t deq, const ud_size_t number)
 {
-  if (deq->size == 0u || cmp_callback_func(p_data, deq->head->data) < 1)
-    return UDPushFront(deq, p_data, data_size);
-
-  if (cmp_callback_func(p_data, deq->tail->data) > -1)
-    return UDPushBack(deq, p_data, data_size);
-
-  ud_element_t new_element = NULL;
-  void *new_data = NULL;
-  if ((new_element = (ud_element_t)malloc(sizeof(struct ud_element))) == NULL || (new_data = malloc(data_size)) == NULL)
+  int ret = 1;
+  if (deq->storage == UD_STORAGE_BLOCKS)
+    ret = 0; // the values are allocated separately, or copied to pages that are allocated as needed
+  else if (deq->storage == UD_STORAGE_RING)
   {
-    deq->err = 1;
-    free(new_element);
-    return NULL;
+    if (deq->ring.bounded != 0)
+      ret = deq->ring.capacity - deq->size >= number;
+    else if (deq->ring.capacity - deq->size < number)
+      ret = number <= SIZE_MAX / deq->elem_size - deq->size && RingResize(deq, deq->size + number);
   }
-
-  new_element->data = memcpy(new_data, p_data, data_size);
-  ud_element_t current_element = deq->head->next;
-  for ( ; current_element != deq->tail && cmp_callback_func(current_element->data, p_data) < 0; current_element = current_element->next);
-  current_element->previous->next = new_element;
-  new_element->previous = current_element->previous;
-  new_element->next = current_element;
-  current_element->previous = new_element;
-  ++deq->size;
-  deq->err = 0;
-  return new_data;
-}
-
-ud_size_t UDFind(const ud_t deq, const void *const p_data, ud_cmp_t cmp_callback_func)
-{
-  ud_size_t index = 0u;
-  for (ud_element_t current_element = deq->head; current_element != NULL; current_element = current_element->next, ++index)
+  else if (deq->storage == UD_STORAGE_COMPACT)
   {
-    if (cmp_callback_func(p_data, current_element->data) == 0)
+    if (deq->compact.capacity - deq->size < number)
+      ret = number < UD_NIL_NODE - deq->size && CompactGrow(deq, (uint32_t)(deq->size + number));
+  }
+  else if (deq->pool.enabled != 0)
+  {
+    ret = number <= SIZE_MAX / UD_POOL_CELL_SIZE;
+    while (ret != 0 && deq->pool.free_count < number)
+      ret = PoolAddSlab(deq);
+  }
+  else if (deq->hash != NULL)
+    ret = 0; // the elements and their levels are allocated separately
+  else if (deq->arena.chunk_size != 0u)
+  {
+    // the memory is taken from a new chunk if it doesn't fit into the current chunk
+    struct ud_arena *arena = &deq->arena;
+    size_t elem_bytes = (sizeof(struct ud_element) + sizeof(union ud_align) + sizeof(union ud_align) - 1u) / sizeof(union ud_align) * sizeof(union ud_align);
+    size_t size = elem_bytes * (size_t)number;
+    if (number > (SIZE_MAX - sizeof(struct ud_chunk)) / elem_bytes)
+      ret = 0;
+    else if (arena->chunks == NULL || arena->chunks->capacity - arena->chunks->used < size)
     {
-      deq->err = 0;
-      return index;
+      size_t capacity = size > arena->chunk_size ? size : arena->chunk_size;
+      struct ud_chunk *chunk = (struct ud_chunk *)Alloc(deq, sizeof(struct ud_chunk) + capacity);
+      if ((ret = chunk != NULL) != 0)
+      {
+        Account(deq, 0, (ud_ssize_t)sizeof(struct ud_chunk), (ud_ssize_t)capacity);
+        chunk->used = 0u;
+        chunk->capacity = capacity;
+        chunk->next = arena->chunks;
+        arena->chunks = chunk;
+      }
     }
   }
+  else
+    ret = 0; // the elements of a linked list are allocated separately
 
-  deq->err = 1;
-  return UD_INVALID_IDX;
+  deq->err = !ret;
+  return ret;
 }
 
-void *UDRemove(const ud_t deq, const void *const p_data, ud_cmp_t cmp_callback_func)
+int UDShrinkToFit(const ud_t deq)
 {
-  for (ud_element_t current_element = deq->head; current_element != NULL; current_element = current_element->next)
+  int ret = 1;
+  if (deq->storage == UD_STORAGE_BLOCKS)
   {
-    if (cmp_callback_func(p_data, current_element->data) == 0)
+    if (deq->strings.page_size != 0u)
+      ret = UDCompactStrings(deq);
+
+    BlockMapShrink(deq);
+  }
+  else if (deq->storage == UD_STORAGE_RING)
+  {
+    if (deq->ring.bounded == 0)
+      ret = RingResize(deq, deq->size);
+  }
+  else if (deq->storage == UD_STORAGE_COMPACT)
+    ret = CompactShrink(deq);
+  else if (deq->hash != NULL)
+  {
+    if (deq->hash->count > HashFitCount(deq->size))
+      ret = HashResize(deq, HashFitCount(deq->size));
+  }
+  else if (deq->pool.enabled != 0)
+  {
+    for (struct ud_slab *slab = deq->pool.slabs, *next = NULL; slab != NULL; slab = next)
     {
-      --deq->size;
-      void *data = current_element->data;
-      current_element->previous != NULL ? (current_element->previous->next = current_element->next) : (deq->head = current_element->next);
-      current_element->next != NULL ? (current_element->next->previous = current_element->previous) : (deq->tail = current_element->previous);
-      free(current_element);
-      deq->err = 0;
-      return data;
+      next = slab->next;
+      if (slab->live == 0u)
+        PoolFreeSlab(deq, slab);
     }
   }
 
-  deq->err = 1;
-  return NULL;
+  deq->err = !ret;
+  return ret;
 }
 
-int UDReverse(const ud_t deq)
+int UDCompactStrings(const ud_t deq)
 {
-  if (deq->size == 0u)
+  if (deq->strings.page_size == 0u)
   {
     deq->err = 1;
     return 0;
   }
 
-  ud_element_t tmp = NULL;
-  for (ud_element_t current_element = deq->head; current_element != NULL; current_element = tmp)
+  // values in pages that have more released than live bytes are moved to the current page
+  for (ud_size_t i = 0u; i < deq->size; ++i)
   {
-    tmp = current_element->next;
-    current_element->next = current_element->previous;
-    current_element->previous = tmp;
+    void **slot = BlockSlot(&deq->map, i);
+    union ud_str_head *head = (union ud_str_head *)*slot - 1;
+    struct ud_str_page *page = head->value.page;
+    if (page != deq->strings.pages && page->live < page->used - page->live)
+    {
+      size_t data_size = head->value.size;
+      void *new_data = StrAlloc(deq, data_size);
+      if (new_data == NULL)
+      {
+        deq->err = 1;
+        return 0;
+      }
+
+      memcpy(new_data, *slot, data_size);
+      StrRelease(deq, *slot);
+      *slot = new_data;
+    }
   }
 
-  tmp = deq->head;
-  deq->head = deq->tail;
-  deq->tail = tmp;
   deq->err = 0;
   return 1;
 }
 
-ud_size_t UDSize(const ud_t deq)
-{
-  deq->err = 0;
-  return deq->size;
-}
-
-int UDEmpty(const ud_t deq)
+int UDSetFilter(const ud_t deq, ud_hash_t hash_func, ud_cmp_t cmp_callback_func)
 {
-  deq->err = 0;
-  return deq->size == 0u;
-}
+  FilterRelease(deq);
+  if (hash_func != NULL)
+  {
+    if ((deq->filter = (struct ud_filter *)Alloc(deq, sizeof(struct ud_filter))) == NULL)
+    {
+      deq->err = 1;
+      return 0;
+    }
 
-int UDFailed(const ud_t deq)
-{
-  int current_err = deq->err;
-  deq->err = 0;
-  return current_err;
-}
+    memset(deq->filter, 0, sizeof(struct ud_filter));
+    deq->filter->hash_func = hash_func;
+    deq->filter->cmp_func = cmp_callback_func;
+    Account(deq, 0, (ud_ssize_t)sizeof(struct ud_filter), 0);
+    FilterRebuild(deq);
+    if (deq->filter->word_count == 0u)
+    {
+      FilterRelease(deq);
+      deq->err = 1;
+      return 0;
+    }
+  }
 
-void UDDeleteData(const ud_t deq, void *p_data)
-{
   deq->err = 0;
-  free(p_data);
+  return 1;
 }
 
 void UDClose(ud_t deq)
 {
   if (deq != NULL)
   {
-    ud_element_t element = deq->head;
-    while (element != NULL)
+    UDClear(deq);
+    for (ud_size_t i = 0u; i < deq->map.count; ++i)
+      Free(deq, deq->map.blocks[i]);
+
+    Free(deq, deq->map.blocks);
+    Free(deq, deq->ring.buffer);
+    Free(deq, deq->compact.table);
+    Free(deq, deq->spare);
+    Free(deq, deq->skip);
+    FilterRelease(deq);
+    if (deq->hash != NULL)
+    {
+      Free(deq, deq->hash->buckets);
+      Free(deq, deq->hash);
+    }
+
+    while (deq->pool.slabs != NULL)
+    {
+      struct ud_slab *next = deq->pool.slabs->next;
+      Free(deq, deq->pool.slabs);
+      deq->pool.slabs = next;
+    }
+
+    while (deq->strings.pages != NULL)
     {
-      ud_element_t next = element->next;
-      free(element->data);
-      free(element);
-      element = next;
+      struct ud_str_page *next = deq->strings.pages->next;
+      Free(deq, deq->strings.pages);
+      deq->strings.pages = next;
     }
 
-    free(deq);
+    ud_allocator_t allocator = deq->allocator;
+    allocator.free_func(allocator.context, deq);
   }
 }
 
@@ -767,12 +3974,12 @@ long double UDFrontLD(const ud_t deq)
 
 char UDPopFrontC(const ud_t deq)
 {
-  void *ptr = UDFront(deq);
+  void *ptr = UDPopFront(deq);
   if (ptr == NULL)
     return 0;
 
   char val = *(char *)ptr;
-  free(ptr);
+  UDDeleteData(deq, ptr);
   return val;
 }
 
@@ -783,7 +3990,7 @@ signed char UDPopFrontSC(const ud_t deq)
     return 0;
 
   signed char val = *(signed char *)ptr;
-  free(ptr);
+  UDDeleteData(deq, ptr);
   return val;
 }
 
@@ -794,7 +4001,7 @@ unsigned char UDPopFrontUC(const ud_t deq)
     return 0;
 
   unsigned char val = *(unsigned char *)ptr;
-  free(ptr);
+  UDDeleteData(deq, ptr);
   return val;
 }
 
@@ -805,7 +4012,7 @@ short UDPopFrontS(const ud_t deq)
     return 0;
 
   short val = *(short *)ptr;
-  free(ptr);
+  UDDeleteData(deq, ptr);
   return val;
 }
 
@@ -816,7 +4023,7 @@ unsigned short UDPopFrontUS(const ud_t deq)
     return 0;
 
   unsigned short val = *(unsigned short *)ptr;
-  free(ptr);
+  UDDeleteData(deq, ptr);
   return val;
 }
 
@@ -827,7 +4034,7 @@ int UDPopFrontI(const ud_t deq)
     return 0;
 
   int val = *(int *)ptr;
-  free(ptr);
+  UDDeleteData(deq, ptr);
   return val;
 }
 
@@ -838,7 +4045,7 @@ unsigned int UDPopFrontUI(const ud_t deq)
     return 0;
 
   unsigned int val = *(unsigned int *)ptr;
-  free(ptr);
+  UDDeleteData(deq, ptr);
   return val;
 }
 
@@ -849,7 +4056,7 @@ long UDPopFrontL(const ud_t deq)
     return 0;
 
   long val = *(long *)ptr;
-  free(ptr);
+  UDDeleteData(deq, ptr);
   return val;
 }
 
@@ -860,7 +4067,7 @@ unsigned long UDPopFrontUL(const ud_t deq)
     return 0;
 
   unsigned long val = *(unsigned long *)ptr;
-  free(ptr);
+  UDDeleteData(deq, ptr);
   return val;
 }
 
@@ -871,7 +4078,7 @@ long long UDPopFrontLL(const ud_t deq)
     return 0;
 
   long long val = *(long long *)ptr;
-  free(ptr);
+  UDDeleteData(deq, ptr);
   return val;
 }
 
@@ -882,7 +4089,7 @@ unsigned long long UDPopFrontULL(const ud_t deq)
     return 0;
 
   unsigned long long val = *(unsigned long long *)ptr;
-  free(ptr);
+  UDDeleteData(deq, ptr);
   return val;
 }
 
@@ -893,7 +4100,7 @@ float UDPopFrontF(const ud_t deq)
     return 0;
 
   float val = *(float *)ptr;
-  free(ptr);
+  UDDeleteData(deq, ptr);
   return val;
 }
 
@@ -904,7 +4111,7 @@ double UDPopFrontD(const ud_t deq)
     return 0;
 
   double val = *(double *)ptr;
-  free(ptr);
+  UDDeleteData(deq, ptr);
   return val;
 }
 
@@ -915,7 +4122,7 @@ long double UDPopFrontLD(const ud_t deq)
     return 0;
 
   long double val = *(long double *)ptr;
-  free(ptr);
+  UDDeleteData(deq, ptr);
   return val;
 }
 
@@ -1122,7 +4329,7 @@ char UDPopBackC(const ud_t deq)
     return 0;
 
   char val = *(char *)ptr;
-  free(ptr);
+  UDDeleteData(deq, ptr);
   return val;
 }
 
@@ -1133,7 +4340,7 @@ signed char UDPopBackSC(const ud_t deq)
     return 0;
 
   signed char val = *(signed char *)ptr;
-  free(ptr);
+  UDDeleteData(deq, ptr);
   return val;
 }
 
@@ -1144,7 +4351,7 @@ unsigned char UDPopBackUC(const ud_t deq)
     return 0;
 
   unsigned char val = *(unsigned char *)ptr;
-  free(ptr);
+  UDDeleteData(deq, ptr);
   return val;
 }
 
@@ -1155,7 +4362,7 @@ short UDPopBackS(const ud_t deq)
     return 0;
 
   short val = *(short *)ptr;
-  free(ptr);
+  UDDeleteData(deq, ptr);
   return val;
 }
 
@@ -1166,7 +4373,7 @@ unsigned short UDPopBackUS(const ud_t deq)
     return 0;
 
   unsigned short val = *(unsigned short *)ptr;
-  free(ptr);
+  UDDeleteData(deq, ptr);
   return val;
 }
 
@@ -1177,7 +4384,7 @@ int UDPopBackI(const ud_t deq)
     return 0;
 
   int val = *(int *)ptr;
-  free(ptr);
+  UDDeleteData(deq, ptr);
   return val;
 }
 
@@ -1188,7 +4395,7 @@ unsigned int UDPopBackUI(const ud_t deq)
     return 0;
 
   unsigned int val = *(unsigned int *)ptr;
-  free(ptr);
+  UDDeleteData(deq, ptr);
   return val;
 }
 
@@ -1199,7 +4406,7 @@ long UDPopBackL(const ud_t deq)
     return 0;
 
   long val = *(long *)ptr;
-  free(ptr);
+  UDDeleteData(deq, ptr);
   return val;
 }
 
@@ -1210,7 +4417,7 @@ unsigned long UDPopBackUL(const ud_t deq)
     return 0;
 
   unsigned long val = *(unsigned long *)ptr;
-  free(ptr);
+  UDDeleteData(deq, ptr);
   return val;
 }
 
@@ -1221,7 +4428,7 @@ long long UDPopBackLL(const ud_t deq)
     return 0;
 
   long long val = *(long long *)ptr;
-  free(ptr);
+  UDDeleteData(deq, ptr);
   return val;
 }
 
@@ -1232,7 +4439,7 @@ unsigned long long UDPopBackULL(const ud_t deq)
     return 0;
 
   unsigned long long val = *(unsigned long long *)ptr;
-  free(ptr);
+  UDDeleteData(deq, ptr);
   return val;
 }
 
@@ -1243,7 +4450,7 @@ float UDPopBackF(const ud_t deq)
     return 0;
 
   float val = *(float *)ptr;
-  free(ptr);
+  UDDeleteData(deq, ptr);
   return val;
 }
 
@@ -1254,7 +4461,7 @@ double UDPopBackD(const ud_t deq)
     return 0;
 
   double val = *(double *)ptr;
-  free(ptr);
+  UDDeleteData(deq, ptr);
   return val;
 }
 
@@ -1265,7 +4472,7 @@ long double UDPopBackLD(const ud_t deq)
     return 0;
 
   long double val = *(long double *)ptr;
-  free(ptr);
+  UDDeleteData(deq, ptr);
   return val;
 }
 
@@ -1472,7 +4679,7 @@ char UDEraseC(const ud_t deq, const ud_size_t index)
     return 0;
 
   char val = *(char *)ptr;
-  free(ptr);
+  UDDeleteData(deq, ptr);
   return val;
 }
 
@@ -1483,7 +4690,7 @@ signed char UDEraseSC(const ud_t deq, const ud_size_t index)
     return 0;
 
   signed char val = *(signed char *)ptr;
-  free(ptr);
+  UDDeleteData(deq, ptr);
   return val;
 }
 
@@ -1494,7 +4701,7 @@ unsigned char UDEraseUC(const ud_t deq, const ud_size_t index)
     return 0;
 
   unsigned char val = *(unsigned char *)ptr;
-  free(ptr);
+  UDDeleteData(deq, ptr);
   return val;
 }
 
@@ -1505,7 +4712,7 @@ short UDEraseS(const ud_t deq, const ud_size_t index)
     return 0;
 
   short val = *(short *)ptr;
-  free(ptr);
+  UDDeleteData(deq, ptr);
   return val;
 }
 
@@ -1516,7 +4723,7 @@ unsigned short UDEraseUS(const ud_t deq, const ud_size_t index)
     return 0;
 
   unsigned short val = *(unsigned short *)ptr;
-  free(ptr);
+  UDDeleteData(deq, ptr);
   return val;
 }
 
@@ -1527,7 +4734,7 @@ int UDEraseI(const ud_t deq, const ud_size_t index)
     return 0;
 
   int val = *(int *)ptr;
-  free(ptr);
+  UDDeleteData(deq, ptr);
   return val;
 }
 
@@ -1538,7 +4745,7 @@ unsigned int UDEraseUI(const ud_t deq, const ud_size_t index)
     return 0;
 
   unsigned int val = *(unsigned int *)ptr;
-  free(ptr);
+  UDDeleteData(deq, ptr);
   return val;
 }
 
@@ -1549,7 +4756,7 @@ long UDEraseL(const ud_t deq, const ud_size_t index)
     return 0;
 
   long val = *(long *)ptr;
-  free(ptr);
+  UDDeleteData(deq, ptr);
   return val;
 }
 
@@ -1560,7 +4767,7 @@ unsigned long UDEraseUL(const ud_t deq, const ud_size_t index)
     return 0;
 
   unsigned long val = *(unsigned long *)ptr;
-  free(ptr);
+  UDDeleteData(deq, ptr);
   return val;
 }
 
@@ -1571,7 +4778,7 @@ long long UDEraseLL(const ud_t deq, const ud_size_t index)
     return 0;
 
   long long val = *(long long *)ptr;
-  free(ptr);
+  UDDeleteData(deq, ptr);
   return val;
 }
 
@@ -1582,7 +4789,7 @@ unsigned long long UDEraseULL(const ud_t deq, const ud_size_t index)
     return 0;
 
   unsigned long long val = *(unsigned long long *)ptr;
-  free(ptr);
+  UDDeleteData(deq, ptr);
   return val;
 }
 
@@ -1593,7 +4800,7 @@ float UDEraseF(const ud_t deq, const ud_size_t index)
     return 0;
 
   float val = *(float *)ptr;
-  free(ptr);
+  UDDeleteData(deq, ptr);
   return val;
 }
 
@@ -1604,7 +4811,7 @@ double UDEraseD(const ud_t deq, const ud_size_t index)
     return 0;
 
   double val = *(double *)ptr;
-  free(ptr);
+  UDDeleteData(deq, ptr);
   return val;
 }
 
@@ -1615,7 +4822,7 @@ long double UDEraseLD(const ud_t deq, const ud_size_t index)
     return 0;
 
   long double val = *(long double *)ptr;
-  free(ptr);
+  UDDeleteData(deq, ptr);
   return val;
 }
 
@@ -1709,164 +4916,602 @@ wchar_t *UDEraseWStr(const ud_t deq, const ud_size_t index)
   return (wchar_t*)UDErase(deq, index);
 }
 
+/* Returns the bits of an integral value of the specified size. */
+static uint64_t IntegralBits(const void *p_data, const size_t size)
+{
+  if (size == sizeof(uint8_t))
+    return *(const uint8_t *)p_data;
+
+  if (size == sizeof(uint16_t))
+  {
+    uint16_t value;
+    memcpy(&value, p_data, sizeof(value));
+    return value;
+  }
+
+  if (size == sizeof(uint32_t))
+  {
+    uint32_t value;
+    memcpy(&value, p_data, sizeof(value));
+    return value;
+  }
+
+  uint64_t value;
+  memcpy(&value, p_data, sizeof(value));
+  return value;
+}
+
+/* Stable LSD radix sort of keyed data pointers by the specified number of lower bytes of the keys, using one pass per byte. Passes for bytes
+   that are the same in all keys are skipped. The keyed items are moved between the array and the buffer of the same size, the array that
+   holds the sorted items is returned. */
+static struct ud_keyed *RadixSortKeyed(struct ud_keyed *keyed, struct ud_keyed *buffer, const ud_size_t count, const size_t key_bytes)
+{
+  ud_size_t counts[sizeof(uint64_t)][256];
+  memset(counts, 0, sizeof(counts));
+  for (ud_size_t i = 0u; i < count; ++i)
+  {
+    for (size_t byte = 0u; byte < key_bytes; ++byte)
+      ++counts[byte][(keyed[i].key >> (byte * 8u)) & 0xffu];
+  }
+
+  struct ud_keyed *src = keyed, *dest = buffer;
+  for (size_t byte = 0u; byte < key_bytes; ++byte)
+  {
+    ud_size_t *digit_count = counts[byte];
+    if (digit_count[(src->key >> (byte * 8u)) & 0xffu] == count)
+      continue;
+
+    // the counts are turned into the positions of the first key of each digit in the destination
+    for (ud_size_t digit = 0u, pos = 0u, tmp = 0u; digit < 256u; ++digit, pos += tmp)
+    {
+      tmp = digit_count[digit];
+      digit_count[digit] = pos;
+    }
+
+    for (ud_size_t i = 0u; i < count; ++i)
+      dest[digit_count[(src[i].key >> (byte * 8u)) & 0xffu]++] = src[i];
+
+    struct ud_keyed *tmp = src;
+    src = dest;
+    dest = tmp;
+  }
+
+  return src;
+}
+
+/* Stable insertion sort of a few keyed data pointers by their keys. */
+static void InsertionSortKeyed(struct ud_keyed *keyed, const ud_size_t count)
+{
+  for (ud_size_t i = 1u; i < count; ++i)
+  {
+    struct ud_keyed item = keyed[i];
+    ud_size_t pos = i;
+    for (; pos > 0u && keyed[pos - 1u].key > item.key; --pos)
+      keyed[pos] = keyed[pos - 1u];
+
+    keyed[pos] = item;
+  }
+}
+
+/* Stable LSD radix sort of integral values of the specified size. The keys are made unsigned by flipping the sign bit of signed values, and
+   are inverted for the descending order. Small deques, and deques whose buffers can't be allocated, are sorted using UDSort() and the
+   comparison function. */
+static int SortIntegral(const ud_t deq, ud_cmp_t cmp_callback_func, void (*sort_items)(void **, const ud_size_t, void **, ud_cmp_t), const size_t size,
+                        const int is_signed, const int descending)
+{
+  if (deq->size < UD_RADIX_MIN_SIZE || deq->size > SIZE_MAX / 2u / sizeof(struct ud_keyed))
+    return SortDeque(deq, cmp_callback_func, sort_items);
+
+  struct ud_keyed *keyed = (struct ud_keyed *)Alloc(deq, (size_t)deq->size * 2u * sizeof(struct ud_keyed));
+  void **items = (void **)Alloc(deq, (size_t)deq->size * sizeof(void *));
+  unsigned char *new_buffer = NULL;
+  if (keyed == NULL || items == NULL || (deq->storage == UD_STORAGE_RING && (new_buffer = (unsigned char *)Alloc(deq, deq->ring.capacity * deq->elem_size)) == NULL))
+  {
+    Free(deq, keyed);
+    Free(deq, items);
+    return SortDeque(deq, cmp_callback_func, sort_items);
+  }
+
+  uint64_t mask = size < sizeof(uint64_t) ? (UINT64_C(1) << (size * 8u)) - 1u : UINT64_MAX;
+  uint64_t flip = (is_signed != 0 ? UINT64_C(1) << (size * 8u - 1u) : 0u) ^ (descending != 0 ? mask : 0u);
+  int sorted = 1;
+  GatherData(deq, items);
+  for (ud_size_t i = 0u; i < deq->size; ++i)
+  {
+    keyed[i].key = IntegralBits(items[i], size) ^ flip;
+    keyed[i].data = items[i];
+    sorted &= i == 0u || keyed[i].key >= keyed[i - 1u].key;
+  }
+
+  if (sorted == 0)
+  {
+    struct ud_keyed *src = RadixSortKeyed(keyed, keyed + deq->size, deq->size, size);
+    for (ud_size_t i = 0u; i < deq->size; ++i)
+      items[i] = src[i].data;
+
+    ApplyOrder(deq, items, new_buffer);
+  }
+  else
+    Free(deq, new_buffer);
+
+  Free(deq, keyed);
+  Free(deq, items);
+  deq->sorted_cmp = cmp_callback_func;
+  deq->err = 0;
+  return 1;
+}
+
+/* Returns the characters of a string that start at the specified position as a key that compares like the characters. The characters are
+   packed big-endian, as unsigned values for strings of char (like strcmp()) and with the sign bit flipped for signed wchar_t (like wcscmp()),
+   and the slots behind the end of the string are filled with the value of the terminating character. */
+static uint64_t StringKey(const void *str, const size_t pos, const size_t char_size, const uint64_t flip)
+{
+  uint64_t key = 0u, mask = (UINT64_C(1) << (char_size * 8u - 1u) << 1u) - 1u, value = 1u;
+  for (size_t i = 0u; i < sizeof(uint64_t) / char_size; ++i)
+  {
+    if (value != 0u)
+      value = char_size == sizeof(char) ? ((const unsigned char *)str)[pos + i] : (uint64_t)((const wchar_t *)str)[pos + i] & mask;
+
+    key = key << (char_size * 4u) << (char_size * 4u) | (value ^ flip);
+  }
+
+  return key;
+}
+
+/* Stable MSD radix sort of strings by the prefix keys that start at the specified depth. Items of equal keys whose strings continue behind the
+   key are sorted by the next characters. Groups of strings that share more than UD_STR_SORT_MAX_DEPTH characters are merge sorted by
+   the comparison function, using the buffer as array of data pointers. */
+static void SortStringKeys(struct ud_keyed *keyed, struct ud_keyed *buffer, const ud_size_t count, const size_t depth, const size_t char_size,
+                           const uint64_t flip, const uint64_t invert, void (*sort_items)(void **, const ud_size_t, void **, ud_cmp_t), ud_cmp_t cmp_callback_func)
+{
+  if (depth >= UD_STR_SORT_MAX_DEPTH)
+  {
+    void **items = (void **)buffer;
+    for (ud_size_t i = 0u; i < count; ++i)
+      items[i] = keyed[i].data;
+
+    sort_items(items, count, items + count, cmp_callback_func);
+    for (ud_size_t i = 0u; i < count; ++i)
+      keyed[i].data = items[i];
+
+    return;
+  }
+
+  for (ud_size_t i = 0u; i < count; ++i)
+    keyed[i].key = StringKey(keyed[i].data, depth, char_size, flip) ^ invert;
+
+  if (count > UD_KEYED_INSERTION_SIZE)
+  {
+    struct ud_keyed *sorted = RadixSortKeyed(keyed, buffer, count, sizeof(uint64_t));
+    if (sorted != keyed)
+      memcpy(keyed, sorted, (size_t)count * sizeof(struct ud_keyed));
+  }
+  else
+    InsertionSortKeyed(keyed, count);
+
+  // the last character of the key is the terminating character if the string doesn't continue
+  uint64_t last_mask = (UINT64_C(1) << (char_size * 8u - 1u) << 1u) - 1u;
+  for (ud_size_t lo = 0u, hi = 0u; lo < count; lo = hi)
+  {
+    for (hi = lo + 1u; hi < count && keyed[hi].key == keyed[lo].key; ++hi);
+    if (hi - lo > 1u && ((keyed[lo].key ^ invert) & last_mask) != flip)
+      SortStringKeys(keyed + lo, buffer + lo, hi - lo, depth + sizeof(uint64_t) / char_size, char_size, flip, invert, sort_items, cmp_callback_func);
+  }
+}
+
+/* Sorts strings of char or wchar_t by a radix sort of their prefixes of 8 bytes, so that strings that share a long prefix are not compared
+   from the first character again and again. The order of equal strings is retained. Small deques, and deques whose buffers can't be
+   allocated, are sorted using the merge sort. */
+static int SortStrings(const ud_t deq, ud_cmp_t cmp_callback_func, void (*sort_items)(void **, const ud_size_t, void **, ud_cmp_t), const size_t char_size,
+                       const int descending)
+{
+  ud_size_t count = deq->size;
+  if (count < UD_RADIX_MIN_SIZE || count > SIZE_MAX / 2u / sizeof(struct ud_keyed))
+    return SortDeque(deq, cmp_callback_func, sort_items);
+
+  struct ud_keyed *keyed = (struct ud_keyed *)Alloc(deq, (size_t)count * 2u * sizeof(struct ud_keyed));
+  void **items = (void **)Alloc(deq, (size_t)count * sizeof(void *));
+  unsigned char *new_buffer = NULL;
+  if (keyed == NULL || items == NULL || (deq->storage == UD_STORAGE_RING && (new_buffer = (unsigned char *)Alloc(deq, deq->ring.capacity * deq->elem_size)) == NULL))
+  {
+    Free(deq, keyed);
+    Free(deq, items);
+    return SortDeque(deq, cmp_callback_func, sort_items);
+  }
+
+  uint64_t flip = char_size != sizeof(char) && (wchar_t)-1 < 0 ? UINT64_C(1) << (char_size * 8u - 1u) : 0u;
+  GatherData(deq, items);
+  for (ud_size_t i = 0u; i < count; ++i)
+    keyed[i].data = items[i];
+
+  SortStringKeys(keyed, keyed + count, count, 0u, char_size, flip, descending != 0 ? UINT64_MAX : 0u, sort_items, cmp_callback_func);
+  int changed = 0;
+  for (ud_size_t i = 0u; i < count; ++i)
+  {
+    changed |= items[i] != keyed[i].data;
+    items[i] = keyed[i].data;
+  }
+
+  changed != 0 ? ApplyOrder(deq, items, new_buffer) : Free(deq, new_buffer);
+  Free(deq, keyed);
+  Free(deq, items);
+  deq->sorted_cmp = cmp_callback_func;
+  deq->err = 0;
+  return 1;
+}
+
+int UDSortByKey(const ud_t deq, ud_key_t key_func)
+{
+  ud_size_t count = deq->size;
+  struct ud_keyed *keyed = count != 0u && count <= SIZE_MAX / 2u / sizeof(struct ud_keyed) ? (struct ud_keyed *)Alloc(deq, (size_t)count * 2u * sizeof(struct ud_keyed)) : NULL;
+  void **items = keyed != NULL ? (void **)Alloc(deq, (size_t)count * sizeof(void *)) : NULL;
+  unsigned char *new_buffer = NULL;
+  if (items == NULL || (deq->storage == UD_STORAGE_RING && (new_buffer = (unsigned char *)Alloc(deq, deq->ring.capacity * deq->elem_size)) == NULL))
+  {
+    Free(deq, keyed);
+    Free(deq, items);
+    deq->err = 1;
+    return 0;
+  }
+
+  // the key function is called once per element, the keys are compared with each other only
+  uint64_t key_bits = 0u;
+  int sorted = 1;
+  GatherData(deq, items);
+  for (ud_size_t i = 0u; i < count; ++i)
+  {
+    keyed[i].key = key_func(items[i]);
+    keyed[i].data = items[i];
+    key_bits |= keyed[i].key;
+    sorted &= i == 0u || keyed[i].key >= keyed[i - 1u].key;
+  }
+
+  if (sorted == 0)
+  {
+    struct ud_keyed *src = keyed;
+    if (count >= UD_RADIX_MIN_SIZE)
+    {
+      // bytes above the highest bit that is set in any key are zero in all keys and need no pass
+      size_t key_bytes = 0u;
+      for (; key_bytes < sizeof(uint64_t) && (key_bits >> (key_bytes * 8u)) != 0u; ++key_bytes);
+      src = RadixSortKeyed(keyed, keyed + count, count, key_bytes);
+    }
+    else
+      InsertionSortKeyed(keyed, count);
+
+    for (ud_size_t i = 0u; i < count; ++i)
+      items[i] = src[i].data;
+
+    ApplyOrder(deq, items, new_buffer);
+  }
+  else
+    Free(deq, new_buffer);
+
+  Free(deq, keyed);
+  Free(deq, items);
+  deq->sorted_cmp = NULL; // there is no comparison function that the order can be searched by
+  deq->err = 0;
+  return 1;
+}
+
 int UDSortAscC(const ud_t deq)
 {
-  return UDSort(deq, (ud_cmp_t)CmpAscC);
+  return SortIntegral(deq, (ud_cmp_t)CmpAscC, SortItemsAscC, sizeof(char), (char)-1 < 0, 0);
 }
 
 int UDSortDescC(const ud_t deq)
 {
-  return UDSort(deq, (ud_cmp_t)CmpDescC);
+  return SortIntegral(deq, (ud_cmp_t)CmpDescC, SortItemsDescC, sizeof(char), (char)-1 < 0, 1);
 }
 
 int UDSortAscSC(const ud_t deq)
 {
-  return UDSort(deq, (ud_cmp_t)CmpAscSC);
+  return SortIntegral(deq, (ud_cmp_t)CmpAscSC, SortItemsAscSC, sizeof(signed char), 1, 0);
 }
 
 int UDSortDescSC(const ud_t deq)
 {
-  return UDSort(deq, (ud_cmp_t)CmpDescSC);
+  return SortIntegral(deq, (ud_cmp_t)CmpDescSC, SortItemsDescSC, sizeof(signed char), 1, 1);
 }
 
 int UDSortAscUC(const ud_t deq)
 {
-  return UDSort(deq, (ud_cmp_t)CmpAscUC);
+  return SortIntegral(deq, (ud_cmp_t)CmpAscUC, SortItemsAscUC, sizeof(unsigned char), 0, 0);
 }
 
 int UDSortDescUC(const ud_t deq)
 {
-  return UDSort(deq, (ud_cmp_t)CmpDescUC);
+  return SortIntegral(deq, (ud_cmp_t)CmpDescUC, SortItemsDescUC, sizeof(unsigned char), 0, 1);
 }
 
 int UDSortAscS(const ud_t deq)
 {
-  return UDSort(deq, (ud_cmp_t)CmpAscS);
+  return SortIntegral(deq, (ud_cmp_t)CmpAscS, SortItemsAscS, sizeof(short), 1, 0);
 }
 
 int UDSortDescS(const ud_t deq)
 {
-  return UDSort(deq, (ud_cmp_t)CmpDescS);
+  return SortIntegral(deq, (ud_cmp_t)CmpDescS, SortItemsDescS, sizeof(short), 1, 1);
 }
 
 int UDSortAscUS(const ud_t deq)
 {
-  return UDSort(deq, (ud_cmp_t)CmpAscUS);
+  return SortIntegral(deq, (ud_cmp_t)CmpAscUS, SortItemsAscUS, sizeof(unsigned short), 0, 0);
 }
 
 int UDSortDescUS(const ud_t deq)
 {
-  return UDSort(deq, (ud_cmp_t)CmpDescUS);
+  return SortIntegral(deq, (ud_cmp_t)CmpDescUS, SortItemsDescUS, sizeof(unsigned short), 0, 1);
 }
 
 int UDSortAscI(const ud_t deq)
 {
-  return UDSort(deq, (ud_cmp_t)CmpAscI);
+  return SortIntegral(deq, (ud_cmp_t)CmpAscI, SortItemsAscI, sizeof(int), 1, 0);
 }
 
 int UDSortDescI(const ud_t deq)
 {
-  return UDSort(deq, (ud_cmp_t)CmpDescI);
+  return SortIntegral(deq, (ud_cmp_t)CmpDescI, SortItemsDescI, sizeof(int), 1, 1);
 }
 
 int UDSortAscUI(const ud_t deq)
 {
-  return UDSort(deq, (ud_cmp_t)CmpAscUI);
+  return SortIntegral(deq, (ud_cmp_t)CmpAscUI, SortItemsAscUI, sizeof(unsigned int), 0, 0);
 }
 
 int UDSortDescUI(const ud_t deq)
 {
-  return UDSort(deq, (ud_cmp_t)CmpDescUI);
+  return SortIntegral(deq, (ud_cmp_t)CmpDescUI, SortItemsDescUI, sizeof(unsigned int), 0, 1);
 }
 
 int UDSortAscL(const ud_t deq)
 {
-  return UDSort(deq, (ud_cmp_t)CmpAscL);
+  return SortIntegral(deq, (ud_cmp_t)CmpAscL, SortItemsAscL, sizeof(long), 1, 0);
 }
 
 int UDSortDescL(const ud_t deq)
 {
-  return UDSort(deq, (ud_cmp_t)CmpDescL);
+  return SortIntegral(deq, (ud_cmp_t)CmpDescL, SortItemsDescL, sizeof(long), 1, 1);
 }
 
 int UDSortAscUL(const ud_t deq)
 {
-  return UDSort(deq, (ud_cmp_t)CmpAscUL);
+  return SortIntegral(deq, (ud_cmp_t)CmpAscUL, SortItemsAscUL, sizeof(unsigned long), 0, 0);
 }
 
 int UDSortDescUL(const ud_t deq)
 {
-  return UDSort(deq, (ud_cmp_t)CmpDescUL);
+  return SortIntegral(deq, (ud_cmp_t)CmpDescUL, SortItemsDescUL, sizeof(unsigned long), 0, 1);
 }
 
 int UDSortAscLL(const ud_t deq)
 {
-  return UDSort(deq, (ud_cmp_t)CmpAscLL);
+  return SortIntegral(deq, (ud_cmp_t)CmpAscLL, SortItemsAscLL, sizeof(long long), 1, 0);
 }
 
 int UDSortDescLL(const ud_t deq)
 {
-  return UDSort(deq, (ud_cmp_t)CmpDescLL);
+  return SortIntegral(deq, (ud_cmp_t)CmpDescLL, SortItemsDescLL, sizeof(long long), 1, 1);
 }
 
 int UDSortAscULL(const ud_t deq)
 {
-  return UDSort(deq, (ud_cmp_t)CmpAscULL);
+  return SortIntegral(deq, (ud_cmp_t)CmpAscULL, SortItemsAscULL, sizeof(unsigned long long), 0, 0);
 }
 
 int UDSortDescULL(const ud_t deq)
 {
-  return UDSort(deq, (ud_cmp_t)CmpDescULL);
+  return SortIntegral(deq, (ud_cmp_t)CmpDescULL, SortItemsDescULL, sizeof(unsigned long long), 0, 1);
 }
 
 int UDSortAscF(const ud_t deq)
 {
-  return UDSort(deq, (ud_cmp_t)CmpAscF);
+  return SortDeque(deq, (ud_cmp_t)CmpAscF, SortItemsAscF);
 }
 
 int UDSortDescF(const ud_t deq)
 {
-  return UDSort(deq, (ud_cmp_t)CmpDescF);
+  return SortDeque(deq, (ud_cmp_t)CmpDescF, SortItemsDescF);
 }
 
 int UDSortAscD(const ud_t deq)
 {
-  return UDSort(deq, (ud_cmp_t)CmpAscD);
+  return SortDeque(deq, (ud_cmp_t)CmpAscD, SortItemsAscD);
 }
 
 int UDSortDescD(const ud_t deq)
 {
-  return UDSort(deq, (ud_cmp_t)CmpDescD);
+  return SortDeque(deq, (ud_cmp_t)CmpDescD, SortItemsDescD);
 }
 
 int UDSortAscLD(const ud_t deq)
 {
-  return UDSort(deq, (ud_cmp_t)CmpAscLD);
+  return SortDeque(deq, (ud_cmp_t)CmpAscLD, SortItemsAscLD);
 }
 
 int UDSortDescLD(const ud_t deq)
 {
-  return UDSort(deq, (ud_cmp_t)CmpDescLD);
+  return SortDeque(deq, (ud_cmp_t)CmpDescLD, SortItemsDescLD);
 }
 
 int UDSortAscStr(const ud_t deq)
 {
-  return UDSort(deq, (ud_cmp_t)CmpAscStr);
+  return SortStrings(deq, (ud_cmp_t)CmpAscStr, SortItemsAscStr, sizeof(char), 0);
 }
 
 int UDSortDescStr(const ud_t deq)
 {
-  return UDSort(deq, (ud_cmp_t)CmpDescStr);
+  return SortStrings(deq, (ud_cmp_t)CmpDescStr, SortItemsDescStr, sizeof(char), 1);
 }
 
 int UDSortAscWStr(const ud_t deq)
 {
-  return UDSort(deq, (ud_cmp_t)CmpAscWStr);
+  return SortStrings(deq, (ud_cmp_t)CmpAscWStr, SortItemsAscWStr, sizeof(wchar_t), 0);
 }
 
 int UDSortDescWStr(const ud_t deq)
 {
-  return UDSort(deq, (ud_cmp_t)CmpDescWStr);
+  return SortStrings(deq, (ud_cmp_t)CmpDescWStr, SortItemsDescWStr, sizeof(wchar_t), 1);
+}
+
+int UDSortParallelAscC(const ud_t deq, const ud_size_t thread_count)
+{
+  return SortParallel(deq, (ud_cmp_t)CmpAscC, thread_count, SortItemsAscC, MergeItemsAscC);
+}
+
+int UDSortParallelDescC(const ud_t deq, const ud_size_t thread_count)
+{
+  return SortParallel(deq, (ud_cmp_t)CmpDescC, thread_count, SortItemsDescC, MergeItemsDescC);
+}
+
+int UDSortParallelAscSC(const ud_t deq, const ud_size_t thread_count)
+{
+  return SortParallel(deq, (ud_cmp_t)CmpAscSC, thread_count, SortItemsAscSC, MergeItemsAscSC);
+}
+
+int UDSortParallelDescSC(const ud_t deq, const ud_size_t thread_count)
+{
+  return SortParallel(deq, (ud_cmp_t)CmpDescSC, thread_count, SortItemsDescSC, MergeItemsDescSC);
+}
+
+int UDSortParallelAscUC(const ud_t deq, const ud_size_t thread_count)
+{
+  return SortParallel(deq, (ud_cmp_t)CmpAscUC, thread_count, SortItemsAscUC, MergeItemsAscUC);
+}
+
+int UDSortParallelDescUC(const ud_t deq, const ud_size_t thread_count)
+{
+  return SortParallel(deq, (ud_cmp_t)CmpDescUC, thread_count, SortItemsDescUC, MergeItemsDescUC);
+}
+
+int UDSortParallelAscS(const ud_t deq, const ud_size_t thread_count)
+{
+  return SortParallel(deq, (ud_cmp_t)CmpAscS, thread_count, SortItemsAscS, MergeItemsAscS);
+}
+
+int UDSortParallelDescS(const ud_t deq, const ud_size_t thread_count)
+{
+  return SortParallel(deq, (ud_cmp_t)CmpDescS, thread_count, SortItemsDescS, MergeItemsDescS);
+}
+
+int UDSortParallelAscUS(const ud_t deq, const ud_size_t thread_count)
+{
+  return SortParallel(deq, (ud_cmp_t)CmpAscUS, thread_count, SortItemsAscUS, MergeItemsAscUS);
+}
+
+int UDSortParallelDescUS(const ud_t deq, const ud_size_t thread_count)
+{
+  return SortParallel(deq, (ud_cmp_t)CmpDescUS, thread_count, SortItemsDescUS, MergeItemsDescUS);
+}
+
+int UDSortParallelAscI(const ud_t deq, const ud_size_t thread_count)
+{
+  return SortParallel(deq, (ud_cmp_t)CmpAscI, thread_count, SortItemsAscI, MergeItemsAscI);
+}
+
+int UDSortParallelDescI(const ud_t deq, const ud_size_t thread_count)
+{
+  return SortParallel(deq, (ud_cmp_t)CmpDescI, thread_count, SortItemsDescI, MergeItemsDescI);
+}
+
+int UDSortParallelAscUI(const ud_t deq, const ud_size_t thread_count)
+{
+  return SortParallel(deq, (ud_cmp_t)CmpAscUI, thread_count, SortItemsAscUI, MergeItemsAscUI);
+}
+
+int UDSortParallelDescUI(const ud_t deq, const ud_size_t thread_count)
+{
+  return SortParallel(deq, (ud_cmp_t)CmpDescUI, thread_count, SortItemsDescUI, MergeItemsDescUI);
+}
+
+int UDSortParallelAscL(const ud_t deq, const ud_size_t thread_count)
+{
+  return SortParallel(deq, (ud_cmp_t)CmpAscL, thread_count, SortItemsAscL, MergeItemsAscL);
+}
+
+int UDSortParallelDescL(const ud_t deq, const ud_size_t thread_count)
+{
+  return SortParallel(deq, (ud_cmp_t)CmpDescL, thread_count, SortItemsDescL, MergeItemsDescL);
+}
+
+int UDSortParallelAscUL(const ud_t deq, const ud_size_t thread_count)
+{
+  return SortParallel(deq, (ud_cmp_t)CmpAscUL, thread_count, SortItemsAscUL, MergeItemsAscUL);
+}
+
+int UDSortParallelDescUL(const ud_t deq, const ud_size_t thread_count)
+{
+  return SortParallel(deq, (ud_cmp_t)CmpDescUL, thread_count, SortItemsDescUL, MergeItemsDescUL);
+}
+
+int UDSortParallelAscLL(const ud_t deq, const ud_size_t thread_count)
+{
+  return SortParallel(deq, (ud_cmp_t)CmpAscLL, thread_count, SortItemsAscLL, MergeItemsAscLL);
+}
+
+int UDSortParallelDescLL(const ud_t deq, const ud_size_t thread_count)
+{
+  return SortParallel(deq, (ud_cmp_t)CmpDescLL, thread_count, SortItemsDescLL, MergeItemsDescLL);
+}
+
+int UDSortParallelAscULL(const ud_t deq, const ud_size_t thread_count)
+{
+  return SortParallel(deq, (ud_cmp_t)CmpAscULL, thread_count, SortItemsAscULL, MergeItemsAscULL);
+}
+
+int UDSortParallelDescULL(const ud_t deq, const ud_size_t thread_count)
+{
+  return SortParallel(deq, (ud_cmp_t)CmpDescULL, thread_count, SortItemsDescULL, MergeItemsDescULL);
+}
+
+int UDSortParallelAscF(const ud_t deq, const ud_size_t thread_count)
+{
+  return SortParallel(deq, (ud_cmp_t)CmpAscF, thread_count, SortItemsAscF, MergeItemsAscF);
+}
+
+int UDSortParallelDescF(const ud_t deq, const ud_size_t thread_count)
+{
+  return SortParallel(deq, (ud_cmp_t)CmpDescF, thread_count, SortItemsDescF, MergeItemsDescF);
+}
+
+int UDSortParallelAscD(const ud_t deq, const ud_size_t thread_count)
+{
+  return SortParallel(deq, (ud_cmp_t)CmpAscD, thread_count, SortItemsAscD, MergeItemsAscD);
+}
+
+int UDSortParallelDescD(const ud_t deq, const ud_size_t thread_count)
+{
+  return SortParallel(deq, (ud_cmp_t)CmpDescD, thread_count, SortItemsDescD, MergeItemsDescD);
+}
+
+int UDSortParallelAscLD(const ud_t deq, const ud_size_t thread_count)
+{
+  return SortParallel(deq, (ud_cmp_t)CmpAscLD, thread_count, SortItemsAscLD, MergeItemsAscLD);
+}
+
+int UDSortParallelDescLD(const ud_t deq, const ud_size_t thread_count)
+{
+  return SortParallel(deq, (ud_cmp_t)CmpDescLD, thread_count, SortItemsDescLD, MergeItemsDescLD);
+}
+
+int UDSortParallelAscStr(const ud_t deq, const ud_size_t thread_count)
+{
+  return SortParallel(deq, (ud_cmp_t)CmpAscStr, thread_count, SortItemsAscStr, MergeItemsAscStr);
+}
+
+int UDSortParallelDescStr(const ud_t deq, const ud_size_t thread_count)
+{
+  return SortParallel(deq, (ud_cmp_t)CmpDescStr, thread_count, SortItemsDescStr, MergeItemsDescStr);
+}
+
+int UDSortParallelAscWStr(const ud_t deq, const ud_size_t thread_count)
+{
+  return SortParallel(deq, (ud_cmp_t)CmpAscWStr, thread_count, SortItemsAscWStr, MergeItemsAscWStr);
+}
+
+int UDSortParallelDescWStr(const ud_t deq, const ud_size_t thread_count)
+{
+  return SortParallel(deq, (ud_cmp_t)CmpDescWStr, thread_count, SortItemsDescWStr, MergeItemsDescWStr);
 }
 
 char *UDInsertAscC(const ud_t deq, const char value)
@@ -2099,14 +5744,33 @@ ud_size_t UDFindLD(const ud_t deq, const long double value)
   return UDFind(deq, &value, (ud_cmp_t)CmpAscLD);
 }
 
+/* A string is equal to the value of an element whose first bytes are the characters of the string including the terminating null. Values
+   may be bigger than the string (if the string was pushed in a bigger buffer or shortened in place), but never smaller. Thus, elements of
+   a list whose saved sizes are smaller than the size of the string are skipped. */
+static ud_size_t FindString(const ud_t deq, const void *const str, const size_t str_size, ud_cmp_t cmp_callback_func)
+{
+  if (deq->storage != UD_STORAGE_LIST || deq->hash != NULL || deq->sorted_cmp == cmp_callback_func)
+    return UDFind(deq, str, cmp_callback_func);
+
+  ud_size_t index = UD_INVALID_IDX;
+  if (FilterMayContain(deq, str, cmp_callback_func) == 0)
+  {
+    deq->err = 1;
+    return index;
+  }
+
+  deq->err = FindEqualElement(deq, str, str_size, &index) == NULL;
+  return index;
+}
+
 ud_size_t UDFindStr(const ud_t deq, const char *str)
 {
-  return UDFind(deq, str, (ud_cmp_t)CmpAscStr);
+  return FindString(deq, str, strlen(str) + 1u, (ud_cmp_t)CmpAscStr);
 }
 
 ud_size_t UDFindWStr(const ud_t deq, const wchar_t *str)
 {
-  return UDFind(deq, str, (ud_cmp_t)CmpAscWStr);
+  return FindString(deq, str, (wcslen(str) + 1u) * sizeof(wchar_t), (ud_cmp_t)CmpAscWStr);
 }
 
 char UDRemoveC(const ud_t deq, const char value)
@@ -2116,7 +5780,7 @@ char UDRemoveC(const ud_t deq, const char value)
     return 0;
 
   char val = *(char *)ptr;
-  free(ptr);
+  UDDeleteData(deq, ptr);
   return val;
 }
 
@@ -2127,7 +5791,7 @@ signed char UDRemoveSC(const ud_t deq, const signed char value)
     return 0;
 
   signed char val = *(signed char *)ptr;
-  free(ptr);
+  UDDeleteData(deq, ptr);
   return val;
 }
 
@@ -2138,7 +5802,7 @@ unsigned char UDRemoveUC(const ud_t deq, const unsigned char value)
     return 0;
 
   unsigned char val = *(unsigned char *)ptr;
-  free(ptr);
+  UDDeleteData(deq, ptr);
   return val;
 }
 
@@ -2149,7 +5813,7 @@ short UDRemoveS(const ud_t deq, const short value)
     return 0;
 
   short val = *(short *)ptr;
-  free(ptr);
+  UDDeleteData(deq, ptr);
   return val;
 }
 
@@ -2160,7 +5824,7 @@ unsigned short UDRemoveUS(const ud_t deq, const unsigned short value)
     return 0;
 
   unsigned short val = *(unsigned short *)ptr;
-  free(ptr);
+  UDDeleteData(deq, ptr);
   return val;
 }
 
@@ -2171,7 +5835,7 @@ int UDRemoveI(const ud_t deq, const int value)
     return 0;
 
   int val = *(int *)ptr;
-  free(ptr);
+  UDDeleteData(deq, ptr);
   return val;
 }
 
@@ -2182,7 +5846,7 @@ unsigned int UDRemoveUI(const ud_t deq, const unsigned int value)
     return 0;
 
   unsigned int val = *(unsigned int *)ptr;
-  free(ptr);
+  UDDeleteData(deq, ptr);
   return val;
 }
 
@@ -2193,7 +5857,7 @@ long UDRemoveL(const ud_t deq, const long value)
     return 0;
 
   long val = *(long *)ptr;
-  free(ptr);
+  UDDeleteData(deq, ptr);
   return val;
 }
 
@@ -2204,7 +5868,7 @@ unsigned long UDRemoveUL(const ud_t deq, const unsigned long value)
     return 0;
 
   unsigned long val = *(unsigned long *)ptr;
-  free(ptr);
+  UDDeleteData(deq, ptr);
   return val;
 }
 
@@ -2215,7 +5879,7 @@ long long UDRemoveLL(const ud_t deq, const long long value)
     return 0;
 
   long long val = *(long long *)ptr;
-  free(ptr);
+  UDDeleteData(deq, ptr);
   return val;
 }
 
@@ -2226,7 +5890,7 @@ unsigned long long UDRemoveULL(const ud_t deq, const unsigned long long value)
     return 0;
 
   unsigned long long val = *(unsigned long long *)ptr;
-  free(ptr);
+  UDDeleteData(deq, ptr);
   return val;
 }
 
@@ -2237,7 +5901,7 @@ float UDRemoveF(const ud_t deq, const float value)
     return 0;
 
   float val = *(float *)ptr;
-  free(ptr);
+  UDDeleteData(deq, ptr);
   return val;
 }
 
@@ -2248,7 +5912,7 @@ double UDRemoveD(const ud_t deq, const double value)
     return 0;
 
   double val = *(double *)ptr;
-  free(ptr);
+  UDDeleteData(deq, ptr);
   return val;
 }
 
@@ -2259,16 +5923,41 @@ long double UDRemoveLD(const ud_t deq, const long double value)
     return 0;
 
   long double val = *(long double *)ptr;
-  free(ptr);
+  UDDeleteData(deq, ptr);
   return val;
 }
 
+/* Like FindString(), but the element found is removed. */
+static void *RemoveString(const ud_t deq, const void *const str, const size_t str_size, ud_cmp_t cmp_callback_func)
+{
+  if (deq->storage != UD_STORAGE_LIST || deq->hash != NULL || deq->sorted_cmp == cmp_callback_func)
+    return UDRemove(deq, str, cmp_callback_func);
+
+  if (FilterMayContain(deq, str, cmp_callback_func) == 0)
+  {
+    deq->err = 1;
+    return NULL;
+  }
+
+  ud_size_t index = 0u;
+  ud_element_t current_element = FindEqualElement(deq, str, str_size, &index);
+  if (current_element == NULL)
+  {
+    deq->err = 1;
+    return NULL;
+  }
+
+  UnlinkElement(deq, current_element, index);
+  deq->err = 0;
+  return current_element->data;
+}
+
 char *UDRemoveStr(const ud_t deq, const char *str)
 {
-  return (char *)UDRemove(deq, str, (ud_cmp_t)CmpAscStr);
+  return (char *)RemoveString(deq, str, strlen(str) + 1u, (ud_cmp_t)CmpAscStr);
 }
 
 wchar_t *UDRemoveWStr(const ud_t deq, const wchar_t *str)
 {
-  return (wchar_t *)UDRemove(deq, str, (ud_cmp_t)CmpAscWStr);
+  return (wchar_t *)RemoveString(deq, str, (wcslen(str) + 1u) * sizeof(wchar_t), (ud_cmp_t)CmpAscWStr);
 }
@@ -40,17 +40,122 @@ extern "C" {
 
 // Pointer values returned by certain UDPop... or UDErase... functions have to be released using UDDeleteData() if they are not used anymore.
 // +++ NOTE +++ The application shall release pointers returned by functions that are marked with "/// (!)" using UDDeleteData().
+//  In a deque opened by UDOpen() the value is saved in the same block of memory as the list element that contained it. Thus, the element is
+//  not released before UDDeleteData() is called, and the pointers must never be passed to free().
 
 // The number of elements in the deque is returned by the UDSize() function.
 
 // Functions that fail return a zero or NULL value, except of the UDSearch... functions which return UD_INVALID_IDX in this case.
 //  To distinguish between zero values saved in the elements and zero values returned due to the failing of the function, an error flag is set.
 //  UDOpen() does not set the error flag. It returns a NULL pointer if it failed.
-//  Unless the functions UDSize(), UDEmpty(), UDFailed(), and UDDeleteData() that always set the error flag to 0,
+//  Unless the functions UDSize(), UDEmpty(), UDFailed(), UDDeleteData(), and UDClear() that always set the error flag to 0,
 //  all other functions of this library set it to 1 if the functions failed and to 0 if they succeeded.
 //  The UDFailed() function returns the value of this error flag and shall be called directly after a function returns to find out if it failed.
 //  It is illegal to call UDFailed() after UDClose() as it is illegal to use the value returned by UDOpen() after UDClose() was called.
 
+// Instead of UDOpen(), UDOpenBlocks() can be used to open a deque that keeps the pointers to the values in fixed-size blocks which are
+//  indexed by a block map, rather than in a doubly-linked list. This storage engine accesses elements at any index in constant time.
+//  Inserting and erasing elements in the middle of the deque shifts the pointers on the shorter side of the deque.
+//  Apart from the complexity of the functions, both kinds of deques behave the same and all functions of this library can be used for both.
+
+// UDOpenIndexedList() opens a deque like UDOpen() whose elements are additionally linked on the levels of a counted skip list.
+//  Each link on a level saves the number of elements it skips. Thus, elements at any index are found in O(log n) expected time, which
+//  speeds up UDAt..., UDInsert..., UDErase..., and UDInsertSorted() for large deques, while elements are still pushed and popped in O(1)
+//  expected time. The links of the levels take about 26 bytes per element on average (on 64-bit platforms).
+
+// UDOpenHashed() opens a deque like UDOpenIndexedList() whose elements are additionally kept in a hash table, using the hash function passed.
+//  UDFind... and UDRemove... look up the value in the hash table rather than comparing it with each element. Values of the same hash are
+//  compared using the cmp_callback_func passed to UDOpenHashed(), or using the comparison function passed to UDFind() and UDRemove() if NULL
+//  was passed (which is the case for the specialized functions). Values that compare equal shall have the same hash. The UDHash... functions
+//  can be passed for the values of the specialized functions. Floating point values that are NaN are not found. The hash table takes about
+//  24 bytes per element in addition to the links of the levels (on 64-bit platforms).
+
+// UDOpenStrings() opens a deque like UDOpenBlocks() that copies the values (typically the strings passed to the ...Str and ...WStr functions)
+//  into pages of page_size bytes (or 64 KiB if 0 is passed) rather than allocating memory for each value. The memory of popped and erased
+//  values is returned to their page by UDDeleteData(), and a page is released as soon as none of its values is in use anymore.
+//  UDCompactStrings() moves the values of pages that contain more released than used bytes to the current page in order to release the
+//  sparse pages. Pointers returned by the UDPush..., UDInsert..., UDFront..., UDBack..., and UDAt... functions stay valid until the element
+//  is removed or UDCompactStrings() is called. Values that were returned by UDPop..., UDErase..., or UDRemove... functions but not yet
+//  released using UDDeleteData() are invalid after UDClose() was called.
+
+// UDOpenSized() opens a deque that saves values of up to elem_size bytes in a contiguous circular buffer rather than in separately allocated
+//  elements. Pass the size of the type of the values (e.g. sizeof(int) for the ...I functions). Values smaller than elem_size are padded
+//  with zero bytes, functions fail for values bigger than elem_size. The buffer grows if it is full.
+//  Elements at any index are accessed in constant time, and values can be pushed or popped without allocation of memory.
+//  Pointers returned by the UDPush..., UDInsert..., UDFront..., UDBack..., and UDAt... functions refer to the buffer. They are
+//  invalidated by the next function that adds or removes elements, sorts, or reverses the deque.
+//  Pointers returned by the UDPop..., UDErase..., and UDRemove... functions refer to a copy of the value that is overwritten by the next
+//  call of one of these functions. UDDeleteData() does not release any memory in such a deque.
+
+// UDOpenBounded() opens a deque like UDOpenSized() whose buffer is allocated only once for the specified capacity of elements.
+//  The buffer never grows, values that are added to a full deque are handled according to the policy passed.
+//  Thus, a sliding window of the last values added is maintained if the UD_OVERFLOW_OVERWRITE_OLDEST policy is specified.
+//  NULL is returned if the buffer of capacity * elem_size bytes exceeds the range of size_t.
+
+// UDOpenCompact() opens a deque that saves values of up to elem_size bytes like UDOpenSized(), but in the nodes of a doubly-linked list
+//  that are kept in one growable table and linked by 32-bit indexes rather than pointers. The links take 8 bytes per element, and
+//  elements are inserted and erased anywhere without moving other values. A compact deque holds at most UINT32_MAX - 1 elements.
+//  Pointers returned by the functions are invalidated and UDDeleteData() behaves as described for UDOpenSized().
+
+// UDOpenPooled() opens a deque that takes the elements for values of up to 16 bytes (such as the values of the specialized functions for
+//  integral and floating point types) from slabs of preallocated elements. Released elements are recycled through a free list.
+//  Thus, pushing and popping values at a steady number of elements does not perform any allocation.
+//  Slabs that don't contain elements in use anymore are released as soon as more than max_free unused elements are retained.
+//  Values that were returned by UDPop..., UDErase..., or UDRemove... functions but not yet released using UDDeleteData() are
+//  invalid after UDClose() was called for a pooled deque.
+
+// UDOpenWithAllocator() opens a deque that uses the functions defined in the ud_allocator_t structure passed rather than malloc(), realloc(),
+//  and free() for all memory allocated by the library, including the object that controls the deque, the elements, and the values.
+//  The structure is copied and does not need to persist after the function returned.
+
+// UDOpenArena() opens a deque that takes the memory for its elements and values from chunks of chunk_size bytes (or 64 KiB if 0 is passed).
+//  Popped or erased elements are only unlinked. Their memory is not reused, and values returned by UDPop..., UDErase..., or UDRemove...
+//  functions stay valid until UDClear() or UDClose() is called. UDDeleteData() does not release any memory in an arena-backed deque.
+//  UDClear() and UDClose() release all memory of the elements in O(number of chunks).
+
+// Traverse the deque using a cursor of type ud_cursor_t rather than calling UDAt... for increasing indexes, which locates the element again
+//  for each index. UDCursorBegin() sets the cursor to the first element, UDCursorEnd() sets it to the position behind the last element.
+//  UDCursorNext() and UDCursorPrev() move the cursor to the adjacent element and return zero if it doesn't refer to an element afterwards.
+//  UDCursorGet() returns the pointer to the value of the element. UDCursorInsertBefore() inserts a value in front of the cursor, which still
+//  refers to the same element (or to the position behind the last element) afterwards. UDCursorErase() removes the element and moves the
+//  cursor to the next element. A cursor is invalidated by any other function that adds, removes, sorts, or reverses elements, including the
+//  cursor functions called for another cursor of the same deque.
+
+// A deque that was sorted using UDSort... or whose values were only added using UDInsertSorted... (or the UDInsertAsc... and UDInsertDesc...
+//  functions) remembers the comparison function. UDFind... and UDRemove... called with the same comparison function perform a binary search
+//  rather than comparing the value with each element. Adding values using other functions or reversing the deque ends this mode, removing
+//  values doesn't. Values shall not be modified via the returned pointers in a way that changes their order.
+//  UDLowerBound() and UDUpperBound() perform a binary search in a deque that is sorted by the comparison function passed.
+//  The binary search takes O(log n) comparisons. The time to reach the elements in the middle depends on how the deque was opened.
+
+// UDSetFilter() attaches a Bloom filter to the deque that keeps the hashes of the values added, using the hash function passed. UDFind... and
+//  UDRemove... consult the filter first and fail without comparing the value with any element if the filter proves that no element
+//  contains the value. This speeds up searches for values that are mostly missing. The filter is consulted for the comparison function
+//  passed to UDSetFilter(), or for any comparison function if NULL was passed (which is the case for the specialized functions). Values that
+//  compare equal shall have the same hash, and values shall not be modified via the returned pointers. The UDHash... functions can be passed
+//  for the values of the specialized functions. Removed values remain in the filter. It is rebuilt by the next search if more than half of
+//  the values added have been removed or the deque outgrew the filter. The filter takes 2 to 8 bytes per element and reports about 1 in 400
+//  missing values as possibly contained at most. Pass NULL as hash_func to remove the filter.
+
+// Use UDClear() to remove all elements from the deque. The deque is still valid and can be reused.
+
+// UDMemoryUsage() copies the memory usage statistics of the deque to the ud_memory_usage_t structure passed. The statistics are updated by
+//  each function that allocates or releases memory, or adds or removes elements. Thus, UDMemoryUsage() doesn't need to enumerate elements.
+
+// UDReserve() preallocates the memory for the specified number of elements to be added, UDShrinkToFit() releases memory that the deque
+//  retained for elements not in use. UDReserve() fails rather than succeeding without the guarantee that the elements can be added without
+//  allocation of memory. What is reserved or released depends on how the deque was opened:
+//  UDOpenSized(), UDOpenCompact()  - the buffer or table grows to hold the elements, or shrinks to the current number of elements.
+//  UDOpenBounded()                 - the capacity is fixed, UDReserve() fails if the elements don't fit.
+//  UDOpenBlocks(), UDOpenStrings() - the values are allocated separately or copied to pages, UDReserve() fails. Blocks that don't contain
+//                                    elements are released. UDShrinkToFit() calls UDCompactStrings() for a deque opened using UDOpenStrings().
+//  UDOpenHashed()                  - elements are allocated separately, UDReserve() fails. The hash table shrinks to the current number of
+//                                    elements.
+//  UDOpenPooled()                  - slabs are added for the elements of values of up to 16 bytes, unused slabs are released.
+//  UDOpenArena()                   - a chunk is provided for the elements of values of up to 16 bytes, UDShrinkToFit() has no effect.
+//  UDOpen(), UDOpenWithAllocator() - elements are allocated separately, UDReserve() fails and UDShrinkToFit() has no effect.
+//  Pointers to values of a deque opened using UDOpenSized() or UDOpenCompact() are invalidated by both functions.
+
 // Always pass the variable assigned by UDOpen() to the UDClose() function if the deque isn't used anymore.
 //  It releases all allocated memory used in the deque.
 // +++ NOTE +++ The application shall release the pointer returned by UDOpen() using UDClose().
@@ -74,6 +179,49 @@ typedef  uint64_t  ud_size_t;  // unsigned type
 typedef  struct ud_detail  * ud_t;
 
 
+/* Type of a structure that defines the functions used to allocate memory, passed to UDOpenWithAllocator(). */
+typedef  struct ud_allocator
+{
+  void  *(*alloc_func)(void *context, size_t size);
+  void  *(*realloc_func)(void *context, void *ptr, size_t size);
+  void   (*free_func)(void *context, void *ptr);
+  void    *context;
+} ud_allocator_t;
+// The callback functions shall behave like malloc(), realloc(), and free(). None of them can be NULL.
+// The context member is passed as first argument to the callback functions. It can be NULL.
+
+
+/* Policies how a deque opened using UDOpenBounded() handles values that are added if the deque is full. */
+typedef  enum ud_overflow
+{
+  UD_OVERFLOW_FAIL,             // the function fails
+  UD_OVERFLOW_OVERWRITE_OLDEST, // the element at the opposite end is removed (the last element for UDPushFront... and UDInsert... with index 0,
+                                //  the first element otherwise)
+  UD_OVERFLOW_DROP_NEWEST       // the value is not added, the function returns NULL but the error flag is not set
+} ud_overflow_t;
+
+
+/* Type of a structure that receives the memory usage statistics of a deque, passed to UDMemoryUsage(). */
+typedef  struct ud_memory_usage
+{
+  ud_size_t  payload_bytes;  // values of the elements, including values that were removed but not yet released using UDDeleteData()
+  ud_size_t  metadata_bytes; // links, headers, padding, block maps, and the object that controls the deque
+  ud_size_t  free_bytes;     // memory retained for elements to be added (unused pool cells, capacity of buffers, tables, blocks, chunks, and pages)
+  ud_size_t  peak_bytes;     // highest sum of the three values above since the deque was opened
+} ud_memory_usage_t;
+// Temporary buffers allocated by the sort functions are not taken into account.
+
+
+/* Type of a cursor that refers to an element of a deque or to the position behind the last element, passed to the UDCursor... functions. */
+typedef  struct ud_cursor
+{
+  struct ud_element  * element;
+  ud_size_t            index;
+  uint32_t             node;
+} ud_cursor_t;
+// The members are maintained by the UDCursor... functions and shall not be modified by the application.
+
+
 /* Type of a callback function passed to UDForEach(). */
 typedef  int(*ud_for_each_proc_t)(void *element_data, void *user_parameter);
 // Declaration of a callback function:
@@ -99,15 +247,54 @@ typedef  int(*ud_cmp_t)(const void *element_data_1, const void *element_data_2);
 // Return a value greater than zero if the first value comes after the second.
 
 
+/* Type of a hash function passed to UDOpenHashed() and UDSetFilter(). */
+typedef  size_t(*ud_hash_t)(const void *element_data);
+// Declaration of a hash function:
+/*
+  size_t HashFunc(const void *p_data);
+*/
+// HashFunc is a placeholder for the application-defined function name.
+// The parameter is the pointer to the value to be hashed, either a value saved in the deque or the value passed to UDFind() or UDRemove().
+// Return the same value for values that compare equal.
+
+
+/* Type of a key function passed to UDSortByKey(). */
+typedef  uint64_t(*ud_key_t)(const void *element_data);
+// Declaration of a key function:
+/*
+  uint64_t KeyFunc(const void *p_data);
+*/
+// KeyFunc is a placeholder for the application-defined function name.
+// The parameter is the pointer to the value saved in the deque.
+// Return the key that the value is sorted by, values of smaller keys come first. For a signed key return its value with the sign bit
+// flipped, i.e. (uint64_t)key ^ UINT64_C(0x8000000000000000), and for the descending order return the inverted key, i.e. ~key.
+
+
 
 // Overview of functions and groups of functions:
 //  function                                      wrapper macro                 complexity
 //  --------------------------------------------------------------------------------------
 //  UDOpen                                        OPEN                          O(1)
+//  UDOpenBlocks                                  -                             O(1)
+//  UDOpenIndexedList                             -                             O(1)
+//  UDOpenHashed                                  -                             O(1)
+//  UDOpenStrings                                 -                             O(1)
+//  UDOpenSized                                   -                             O(1)
+//  UDOpenBounded                                 -                             O(1)
+//  UDOpenCompact                                 -                             O(1)
+//  UDOpenPooled                                  -                             O(1)
+//  UDOpenWithAllocator                           -                             O(1)
+//  UDOpenArena                                   -                             O(1)
 //  UDSize                                        SIZE                          O(1)
 //  UDEmpty                                       EMPTY                         O(1)
 //  UDFailed                                      FAILED                        O(1)
 //  UDDeleteData                                  DELETE_DATA                   O(1)
+//  UDClear                                       CLEAR                         O(n)
+//  UDMemoryUsage                                 -                             O(1)
+//  UDReserve                                     -                             O(number)
+//  UDShrinkToFit                                 -                             O(n)
+//  UDCompactStrings                              -                             O(n)
+//  UDSetFilter                                   -                             O(n)
 //  UDClose                                       CLOSE                         O(n)
 //  UDPushFront...                                PUSH_FRONT                    O(1)
 //  UDPushBack...                                 PUSH_BACK                     O(1)
@@ -121,9 +308,65 @@ typedef  int(*ud_cmp_t)(const void *element_data_1, const void *element_data_2);
 //  UDRemove...                                   REMOVE                        O(n)
 //  UDReverse                                     REVERSE                       O(n)
 //  UDForEach                                     FOR_EACH                      O(n)
+//  UDCursorBegin / UDCursorEnd                   -                             O(1)
+//  UDCursorNext / UDCursorPrev / UDCursorGet     -                             O(1)
+//  UDCursorInsertBefore / UDCursorErase          -                             O(1)
 //  UDSort...                                     SORT_ASC / SORT_DESC          O(n log n)
-//  UDInsertSorted/UDInsertAsc.../UDInsertDesc... INSERT_ASC / INSERT_DESC      O(n)
+//  UDSortParallel...                             -                             O(n log n / threads + n)
+//  UDSortByKey                                   -                             O(n)
+//  UDInsertSorted/UDInsertAsc.../UDInsertDesc... INSERT_ASC / INSERT_DESC      O(log n) comparisons, O(n)
 //  UDFind...                                     FIND                          O(n)
+//  UDLowerBound / UDUpperBound                   -                             O(log n) comparisons, O(n)
+// Deviating complexity of deques opened using UDOpenArena():
+//  UDClear / UDClose                                                           O(number of chunks)
+// Deviating complexity of deques opened using UDOpenBlocks(), UDOpenStrings(), UDOpenSized(), or UDOpenBounded():
+//  UDPushFront... / UDPushBack...                                              O(1) amortized
+//  UDInsert... / UDErase...                                                    O(min(index, n - index))
+//  UDAt...                                                                     O(1)
+//  UDCursorInsertBefore / UDCursorErase                                        O(min(index, n - index))
+//  UDInsertSorted/UDInsertAsc.../UDInsertDesc...                               O(log n) comparisons, O(n) moves
+//  UDLowerBound / UDUpperBound, UDFind... / UDRemove... of a sorted deque      O(log n)
+// Deviating complexity of deques opened using UDOpenIndexedList():
+//  UDInsert... / UDAt... / UDErase...                                          O(log n) expected
+//  UDCursorInsertBefore / UDCursorErase                                        O(log n) expected
+//  UDInsertSorted/UDInsertAsc.../UDInsertDesc...                               O(log n) comparisons, O(log n * log n) expected
+//  UDLowerBound / UDUpperBound, UDFind... / UDRemove... of a sorted deque      O(log n) comparisons, O(log n * log n) expected
+// Deviating complexity of deques opened using UDOpenHashed() (in addition to the complexity of deques opened using UDOpenIndexedList()):
+//  UDPushFront... / UDPushBack...                                              O(1) amortized expected
+//  UDFind... / UDRemove...                                                     O(1) comparisons, O(log n) expected
+//  UDShrinkToFit                                                               O(n)
+// Deviating complexity of deques that have a filter attached using UDSetFilter():
+//  UDFind... / UDRemove... of a value that no element contains                 O(1) expected
+// Deviating complexity of deques opened using UDOpenCompact():
+//  UDClear                                                                     O(1)
+//  UDPushFront... / UDPushBack... / UDCursorInsertBefore                       O(1) amortized
+//  UDInsert... / UDAt... / UDErase...                                          O(min(index, n - index))
+// The elements of linked lists (deques that were not opened using UDOpenBlocks(), UDOpenStrings(), UDOpenSized(), or UDOpenBounded()) are
+//  reached from the first element, the last element, or the element that was accessed by its index most recently, whichever is closest.
+//  Thus, UDInsert..., UDAt..., UDErase..., and UDForEach take O(distance) for an index close to the index accessed most recently.
+// UDSort... is a stable natural merge sort. Ascending and strictly descending sequences of elements are detected and merged. Thus, sorting
+//  a deque that is already in ascending or strictly descending order takes O(n) comparisons, and a deque of k sorted sequences O(n log k).
+//  A linked list of at least 4096 elements is sorted by the data pointers gathered in a temporary array of 16 bytes per element (on 64-bit
+//  platforms), and the elements are relinked in one pass. Smaller lists, and lists for which the array can't be allocated, are sorted by
+//  relinking the elements in each merge. The specialized UDSortAsc..., UDSortDesc..., UDSortParallelAsc..., and UDSortParallelDesc...
+//  functions sort the array using a version of the merge sort that compares the values of their type directly rather than calling the
+//  comparison function for each pair.
+// The UDSortAsc... and UDSortDesc... functions for integral types sort deques of at least 256 elements using a stable radix sort in O(n),
+//  which takes one pass over the elements per byte of the type and a temporary buffer of about 40 bytes per element (on 64-bit platforms).
+// UDSortAscStr, UDSortDescStr, UDSortAscWStr, and UDSortDescWStr sort deques of at least 256 elements using a stable MSD radix sort of
+//  8-byte prefixes of the strings, read once per element and prefix. Strings that share a prefix are sorted by their next 8 bytes, so common
+//  leading characters are not compared again and again. Strings that share more than 256 leading characters are sorted using the merge
+//  sort. The sort takes a temporary buffer of about 40 bytes per element (on 64-bit platforms).
+// UDSortParallel... sorts segments of the gathered data pointers in separate threads and merges pairs of sorted segments, each merge split
+//  between the threads, using a temporary array of 16 bytes per element (on 64-bit platforms). The result is the same as of UDSort...
+//  (the sort is stable). At most 64 threads are used, and each thread gets at least 65536 elements. Smaller deques, and deques for which
+//  the array can't be allocated, are sorted using UDSort. The comparison function is called from several threads at the same time. The
+//  threads are POSIX threads, or threads started using _beginthreadex() on Windows. If UD_NO_THREADS is defined when compiling the library,
+//  the work of the threads is done one after another.
+// UDSortByKey calls the key function once per element and sorts the elements by these 64-bit keys, using the stable radix sort for deques
+//  of at least 256 elements and an insertion sort of the keys for smaller deques. It takes one pass over the elements per significant byte of
+//  the keys and a temporary buffer of about 40 bytes per element (on 64-bit platforms). The order of elements of equal keys is retained.
+//  As there is no comparison function, UDFind... and UDRemove... of a deque sorted by keys search the elements one by one.
 
 /* macros that wrap the functions of this library, specialized for a specific type */
 #ifndef UD_NO_WRAPPER_MACROS
@@ -137,6 +380,7 @@ typedef  int(*ud_cmp_t)(const void *element_data_1, const void *element_data_2);
 # define EMPTY        UDEmpty
 # define FAILED       UDFailed
 # define DELETE_DATA  UDDeleteData
+# define CLEAR        UDClear
 # define CLOSE        UDClose
 # define PUSH_FRONT   FUNCTION_TYPE_(UDPushFront,UD_TYPE)
 # define PUSH_BACK    FUNCTION_TYPE_(UDPushBack,UD_TYPE)
@@ -182,13 +426,48 @@ typedef  int(*ud_cmp_t)(const void *element_data_1, const void *element_data_2);
 
 /* Frame functions. */
 ud_t       UDOpen(void);
+ud_t       UDOpenBlocks(void);
+ud_t       UDOpenIndexedList(void);
+ud_t       UDOpenHashed(ud_hash_t hash_func, ud_cmp_t cmp_callback_func);
+ud_t       UDOpenStrings(const size_t page_size);
+ud_t       UDOpenSized(const size_t elem_size);
+ud_t       UDOpenBounded(const ud_size_t capacity, const size_t elem_size, const ud_overflow_t policy);
+ud_t       UDOpenCompact(const size_t elem_size);
+ud_t       UDOpenPooled(const ud_size_t max_free);
+ud_t       UDOpenWithAllocator(const ud_allocator_t *allocator);
+ud_t       UDOpenArena(const size_t chunk_size);
 ud_size_t  UDSize(const ud_t deq);
 int        UDEmpty(const ud_t deq);
 int        UDFailed(const ud_t deq);
 void       UDDeleteData(const ud_t deq, void *p_data);
+void       UDClear(const ud_t deq);
+int        UDMemoryUsage(const ud_t deq, ud_memory_usage_t *p_usage);
+int        UDReserve(const ud_t deq, const ud_size_t number);
+int        UDShrinkToFit(const ud_t deq);
+int        UDCompactStrings(const ud_t deq);
+int        UDSetFilter(const ud_t deq, ud_hash_t hash_func, ud_cmp_t cmp_callback_func);
 void       UDClose(ud_t deq);
 
 
+/* Hash functions for the values of the specialized functions, to be passed to UDOpenHashed() or UDSetFilter(). */
+size_t  UDHashC   (const void *p_data);
+size_t  UDHashSC  (const void *p_data);
+size_t  UDHashUC  (const void *p_data);
+size_t  UDHashS   (const void *p_data);
+size_t  UDHashUS  (const void *p_data);
+size_t  UDHashI   (const void *p_data);
+size_t  UDHashUI  (const void *p_data);
+size_t  UDHashL   (const void *p_data);
+size_t  UDHashUL  (const void *p_data);
+size_t  UDHashLL  (const void *p_data);
+size_t  UDHashULL (const void *p_data);
+size_t  UDHashF   (const void *p_data);
+size_t  UDHashD   (const void *p_data);
+size_t  UDHashLD  (const void *p_data);
+size_t  UDHashStr (const void *p_data);
+size_t  UDHashWStr(const void *p_data);
+
+
 /* Generalized functions for pointers to values of any type. */
 void  * UDPushFront(const ud_t deq, const void *const p_data, const size_t data_size);
 
@@ -231,12 +510,43 @@ int  UDForEach(const ud_t deq, const ud_size_t start_idx, const ud_ssize_t numbe
 
 
 
+/* Functions to traverse the deque using a cursor. */
+// UDCursorBegin() and UDCursorEnd() return a non-zero value if the deque contains elements.
+// UDCursorNext() and UDCursorPrev() return a non-zero value if the cursor refers to an element after it was moved. The error flag is only set
+//  if the cursor could not be moved because it was already behind the last element or at the first element.
+// UDCursorInsertBefore() can be called for the position behind the last element in order to append the value, also to an empty deque.
+int     UDCursorBegin(const ud_t deq, ud_cursor_t *p_cursor);
+
+int     UDCursorEnd(const ud_t deq, ud_cursor_t *p_cursor);
+
+int     UDCursorNext(const ud_t deq, ud_cursor_t *p_cursor);
+
+int     UDCursorPrev(const ud_t deq, ud_cursor_t *p_cursor);
+
+void  * UDCursorGet(const ud_t deq, const ud_cursor_t *p_cursor);
+
+void  * UDCursorInsertBefore(const ud_t deq, ud_cursor_t *p_cursor, const void *const p_data, const size_t data_size);
+
+void  * UDCursorErase(const ud_t deq, ud_cursor_t *p_cursor); /// (!)
+
+
+
 /* Function to sort the elements in the deque by their values. */
 int  UDSort(const ud_t deq, ud_cmp_t cmp_callback_func);
 
 
 
-/* Function that inserts a value into a sorted deque. */
+/* Function to sort the elements in the deque by their values using up to the specified number of threads. */
+int  UDSortParallel(const ud_t deq, ud_cmp_t cmp_callback_func, const ud_size_t thread_count);
+
+
+
+/* Function to sort the elements in the deque by the 64-bit keys that the key function returns for their values. */
+int  UDSortByKey(const ud_t deq, ud_key_t key_func);
+
+
+
+/* Function that inserts a value into a sorted deque, behind the elements whose values compare equal. */
 void  * UDInsertSorted(const ud_t deq, const void *const p_data, const size_t data_size, ud_cmp_t cmp_callback_func);
 
 
@@ -246,6 +556,14 @@ ud_size_t  UDFind(const ud_t deq, const void *const p_data, ud_cmp_t cmp_callbac
 
 
 
+/* Functions that return the index of the first element whose value doesn't come before (UDLowerBound) or comes after (UDUpperBound) the
+   value pointed to by p_data, or the number of elements if there is no such element. The deque shall be sorted by cmp_callback_func. */
+ud_size_t  UDLowerBound(const ud_t deq, const void *const p_data, ud_cmp_t cmp_callback_func);
+
+ud_size_t  UDUpperBound(const ud_t deq, const void *const p_data, ud_cmp_t cmp_callback_func);
+
+
+
 /* Specialized functions for integral values. */
 char                * UDPushFrontC  (const ud_t deq, const char               value);
 signed char         * UDPushFrontSC (const ud_t deq, const signed char        value);
@@ -393,6 +711,29 @@ int  UDSortDescLL (const ud_t deq);
 int  UDSortAscULL (const ud_t deq);
 int  UDSortDescULL(const ud_t deq);
 
+int  UDSortParallelAscC   (const ud_t deq, const ud_size_t thread_count);
+int  UDSortParallelDescC  (const ud_t deq, const ud_size_t thread_count);
+int  UDSortParallelAscSC  (const ud_t deq, const ud_size_t thread_count);
+int  UDSortParallelDescSC (const ud_t deq, const ud_size_t thread_count);
+int  UDSortParallelAscUC  (const ud_t deq, const ud_size_t thread_count);
+int  UDSortParallelDescUC (const ud_t deq, const ud_size_t thread_count);
+int  UDSortParallelAscS   (const ud_t deq, const ud_size_t thread_count);
+int  UDSortParallelDescS  (const ud_t deq, const ud_size_t thread_count);
+int  UDSortParallelAscUS  (const ud_t deq, const ud_size_t thread_count);
+int  UDSortParallelDescUS (const ud_t deq, const ud_size_t thread_count);
+int  UDSortParallelAscI   (const ud_t deq, const ud_size_t thread_count);
+int  UDSortParallelDescI  (const ud_t deq, const ud_size_t thread_count);
+int  UDSortParallelAscUI  (const ud_t deq, const ud_size_t thread_count);
+int  UDSortParallelDescUI (const ud_t deq, const ud_size_t thread_count);
+int  UDSortParallelAscL   (const ud_t deq, const ud_size_t thread_count);
+int  UDSortParallelDescL  (const ud_t deq, const ud_size_t thread_count);
+int  UDSortParallelAscUL  (const ud_t deq, const ud_size_t thread_count);
+int  UDSortParallelDescUL (const ud_t deq, const ud_size_t thread_count);
+int  UDSortParallelAscLL  (const ud_t deq, const ud_size_t thread_count);
+int  UDSortParallelDescLL (const ud_t deq, const ud_size_t thread_count);
+int  UDSortParallelAscULL (const ud_t deq, const ud_size_t thread_count);
+int  UDSortParallelDescULL(const ud_t deq, const ud_size_t thread_count);
+
 
 char                * UDInsertAscC   (const ud_t deq, const char               value);
 char                * UDInsertDescC  (const ud_t deq, const char               value);
@@ -483,6 +824,13 @@ int  UDSortDescD (const ud_t deq);
 int  UDSortAscLD (const ud_t deq);
 int  UDSortDescLD(const ud_t deq);
 
+int  UDSortParallelAscF  (const ud_t deq, const ud_size_t thread_count);
+int  UDSortParallelDescF (const ud_t deq, const ud_size_t thread_count);
+int  UDSortParallelAscD  (const ud_t deq, const ud_size_t thread_count);
+int  UDSortParallelDescD (const ud_t deq, const ud_size_t thread_count);
+int  UDSortParallelAscLD (const ud_t deq, const ud_size_t thread_count);
+int  UDSortParallelDescLD(const ud_t deq, const ud_size_t thread_count);
+
 
 float        * UDInsertAscF  (const ud_t deq, const float       value);
 float        * UDInsertDescF (const ud_t deq, const float       value);
@@ -537,6 +885,11 @@ int  UDSortDescStr (const ud_t deq);
 int  UDSortAscWStr (const ud_t deq);
 int  UDSortDescWStr(const ud_t deq);
 
+int  UDSortParallelAscStr  (const ud_t deq, const ud_size_t thread_count);
+int  UDSortParallelDescStr (const ud_t deq, const ud_size_t thread_count);
+int  UDSortParallelAscWStr (const ud_t deq, const ud_size_t thread_count);
+int  UDSortParallelDescWStr(const ud_t deq, const ud_size_t thread_count);
+
 
 char     * UDInsertAscStr  (const ud_t deq, const char    *str);
 char     * UDInsertDescStr (const ud_t deq, const char    *str);